@@ -2,16 +2,26 @@
 #include <QPainter>
 #include <QKeyEvent>
 #include <QFile>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <QFileInfo>
+#include <QCoreApplication>
+#include <QtMath>
+#include <algorithm>
 #include <QProcess>
+#include <QOpenGLFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLPaintDevice>
+#include <QMediaDevices>
+#include <QAudioDevice>
 
 #include <QSoundEffect>
 #include <QJoysticks.h>
 
 #include "pellsBawl.h"
 #include "title.h"
+#include "assets.h"
+#include "bundles.h"
+#include "levelformat.h"
+#include "levelreader.h"
 
 #include <QDebug>
 
@@ -35,20 +45,125 @@ Game::Game(QWidget *parent)
 : QWidget(parent)
 #endif
 {
+    startup = new Startup(this);
+
     audio = new QAudioOutput(this);
     player = new QMediaPlayer(this);
     player->setAudioOutput(audio);
 
     joystick = new GameJoystick(this);
 
-    QTimer *oneShot = new QTimer(this);
-    oneShot->setSingleShot(true);
-    connect(oneShot, &QTimer::timeout, this, &Game::action);
-    oneShot->start(50);
+    // Splash goes up on the first frame, the rest is started behind it
+    startup->begin(Startup::Splash);
+    displayCaption(QPixmap(":/assets/intro/splash.png"), QColor(0, 200, 50));
+    showFullScreen();
+#ifdef USE_OPENGL
+    connect(this, &QOpenGLWidget::frameSwapped, this, &Game::startupBehindSplash, Qt::SingleShotConnection);
+#else
+    QTimer::singleShot(0, this, &Game::startupBehindSplash);
+#endif
 
     setScreenSleepBlock(true);
 }
 
+// First level art, the PellsBawl rig and the caption art, as resolved by loadWorld
+// and at the same decode sizes, so the prefetched copies are the ones it asks for.
+static QList<Assets::Request> levelAssetRequests(const QString &filename, const QString &path, const QSizeF &viewport);
+
+// Art bundles each level draws from (see bundles.h); enemies use levelart.
+static QStringList levelBundles(int level) {
+    switch (level) {
+    case 1: return { "level1", "levelart" };
+    case 2: return { "level2" };
+    case 3: return { "levelart", "mt2" };
+    default: return {};
+    }
+}
+
+void Game::startupBehindSplash() {
+    startup->end(Startup::Splash);
+
+    // Open the audio device and load the jingle before anyone asks for it
+    startup->begin(Startup::Audio);
+    connect(player, &QMediaPlayer::mediaStatusChanged, this, [this](QMediaPlayer::MediaStatus status) {
+        if (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferedMedia
+            || status == QMediaPlayer::InvalidMedia)
+            startup->end(Startup::Audio);
+    });
+    audio->setDevice(QMediaDevices::defaultAudioOutput());
+    player->setSource(QUrl("qrc:/assets/intro/pellsBawl_intro_jingle.wav"));
+
+    // Decode everything level1() needs on the thread pool
+    Bundles::mount(levelBundles(1));
+    QList<Assets::Request> requests = levelAssetRequests("level1_wportal.json", ":/assets/level1/", viewportSize());
+    requests << Assets::Request{":/assets/intro/level01.jpg", viewportSize().toSize()};
+    for (const QString &part : PellsBawl::partPaths()) requests << Assets::Request{part, QSize()};
+    for (const QString &art : EnemyTypes::artPaths()) requests << Assets::Request{art, QSize()};
+    startup->decodeInBackground(requests);
+
+    QTimer::singleShot(0, this, &Game::action);
+}
+
+#ifdef USE_OPENGL
+void Game::initializeGL() {
+    startup->begin(Startup::GL);
+
+    QOpenGLFunctions *f = context()->functions();
+    const char *vendor   = reinterpret_cast<const char*>(f->glGetString(GL_VENDOR));
+    const char *renderer = reinterpret_cast<const char*>(f->glGetString(GL_RENDERER));
+    const char *version  = reinterpret_cast<const char*>(f->glGetString(GL_VERSION));
+    const char *slVer    = reinterpret_cast<const char*>(f->glGetString(GL_SHADING_LANGUAGE_VERSION));
+
+    qDebug().noquote()
+      << "GL_VENDOR  :" << (vendor ? vendor : "(null)") << "\n"
+      << "GL_RENDERER:" << (renderer ? renderer : "(null)") << "\n"
+      << "GL_VERSION :" << (version ? version : "(null)") << "\n"
+      << "GLSL       :" << (slVer ? slVer : "(null)");
+
+    startup->end(Startup::GL);
+
+    startup->begin(Startup::Shaders);
+    warmUpPaintEngine();
+    startup->end(Startup::Shaders);
+
+    textures.initialize();
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, [this]{
+        makeCurrent(); textures.cleanup(); doneCurrent();
+    });
+}
+
+// Draw one of everything a frame uses into a throwaway FBO, so the GL paint
+// engine compiles its shader programs (or loads them from Qt's program binary
+// disk cache) now, instead of on the frame where they first show up.
+void Game::warmUpPaintEngine() {
+    QOpenGLFramebufferObject fbo(64, 64, QOpenGLFramebufferObject::CombinedDepthStencil);
+    if (!fbo.bind()) return;
+    {
+        QOpenGLPaintDevice device(fbo.size());
+        QPainter p(&device);
+        p.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform, true);
+        p.fillRect(QRect(0, 0, 64, 64), Qt::white);
+
+        QPixmap px(16, 16); px.fill(QColor(0, 0, 0, 128));
+        p.drawPixmap(QRect(0, 0, 32, 32), px);
+        p.save(); p.translate(32, 32); p.rotate(30); p.scale(-1.25, 1.25); p.drawPixmap(QPointF(-8, -8), px); p.restore();
+        p.drawImage(QRectF(32, 0, 16, 16), px.toImage());
+
+        QRadialGradient g(QPointF(32, 32), 16);
+        g.setColorAt(0.0, QColor(0, 0, 0, 90));
+        g.setColorAt(1.0, QColor(0, 0, 0, 0));
+        p.setPen(Qt::NoPen); p.setBrush(g); p.drawEllipse(QRectF(16, 16, 32, 32));
+        p.setBrush(QColor(0x22c55e)); p.drawRoundedRect(QRectF(4, 40, 40, 12), 3, 3);
+
+        p.setPen(QPen(QColor(255,255,255,40), 1, Qt::DashLine)); p.drawLine(0, 60, 64, 60);
+        p.setFont(QFont("Monospace", 9, QFont::DemiBold));
+        p.drawText(QRect(0, 40, 64, 16), Qt::AlignCenter, "0%");
+    }
+    fbo.release();
+    context()->functions()->glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+}
+#endif
+
 void Game::setScreenSleepBlock(bool enable) {
     if (enable == m_screenSleepBlocked) return;
     m_screenSleepBlocked = enable;
@@ -88,30 +203,12 @@ void Game::setScreenSleepBlock(bool enable) {
 }
 
 void Game::displayCaption(QPixmap pixmap, const QColor &color, bool full) {
-    auto *ctx = QOpenGLContext::currentContext();
-    if (!ctx) {
-      qDebug() << "No current OpenGL context!";
-      return;
-    }
-
-    QOpenGLFunctions *f = ctx->functions();
-    const char *vendor   = reinterpret_cast<const char*>(f->glGetString(GL_VENDOR));
-    const char *renderer = reinterpret_cast<const char*>(f->glGetString(GL_RENDERER));
-    const char *version  = reinterpret_cast<const char*>(f->glGetString(GL_VERSION));
-    const char *slVer    = reinterpret_cast<const char*>(f->glGetString(GL_SHADING_LANGUAGE_VERSION));
-
-    qDebug().noquote()
-      << "GL_VENDOR  :" << (vendor ? vendor : "(null)") << "\n"
-      << "GL_RENDERER:" << (renderer ? renderer : "(null)") << "\n"
-      << "GL_VERSION :" << (version ? version : "(null)") << "\n"
-      << "GLSL       :" << (slVer ? slVer : "(null)");
-
     pause(); titleGraphics = pixmap; showTitle = true; showFullscreen = full; titleBg = color; update();
 }
 
 void Game::playJingle(QString jingle, bool repeat) {
     if (!jingle.isEmpty()) {
-        player->setSource(QUrl(jingle));
+        if (player->source() != QUrl(jingle)) player->setSource(QUrl(jingle));
         audio->setVolume(0.8);
         player->setLoops(repeat ? QMediaPlayer::Infinite : QMediaPlayer::Once);
         player->play();
@@ -125,8 +222,6 @@ void Game::playSfx(const QString &sfx) {
     fx.setVolume(0.35f);
 }
 void Game::action() {
-    showFullScreen();
-    displayCaption(QPixmap(":/assets/intro/splash.png"), QColor(0, 200, 50));
     playJingle("qrc:/assets/intro/pellsBawl_intro_jingle.wav");
     joystick->waitForPush();
     clearCaption();
@@ -144,22 +239,25 @@ void Game::nextLevel()
 
 void Game::level1()
 {
-    displayCaption(QPixmap(":/assets/intro/level01.jpg"), QColor(0, 200, 50), true); //fullScr
+    startup->waitForDecode();
+
+    displayCaption(Assets::loadPixmap(":/assets/intro/level01.jpg", viewportSize().toSize()), QColor(0, 200, 50), true); //fullScr
     playJingle("qrc:/assets/intro/pellsBawl_intro_jingle.wav");
     joystick->waitForPush();
     clearCaption();
 
     level = 1;
+    Bundles::mount(levelBundles(level));
     // Load platforms from a JSON file
     loadWorld("level1_wportal.json", ":/assets/level1/");
 
     pellsBawl = new PellsBawl(this);
+    Archetypes::player(entities, pellsBawl);
     joyCommander = new PellsBawlCommander(this, pellsBawl);
     joystick->setCommander(joyCommander);
-
-    // Create enemies and assign them to platforms
-    enemies.append(Enemy(110, 412, 40, 40));  // Example enemy 1 on platform
-    enemies.append(Enemy(310, 312, 40, 40));  // Example enemy 2 on platform
+#ifdef USE_OPENGL
+    for (const QPixmap &px : pellsBawl->pixmaps()) textures.prime(px);
+#endif
 
     unpause();
 }
@@ -174,13 +272,18 @@ void Game::level2()
     pause(); clear(true); // keep pb
 
     //load artifacts for level 2...
+    Bundles::mount(levelBundles(level));
 
            // Load platforms from a JSON file
     loadWorld("level2.json", ":/assets/level2/");
 
     pellsBawl = new PellsBawl(this);
+    Archetypes::player(entities, pellsBawl);
     joyCommander = new PellsBawlCommander(this, pellsBawl);
     joystick->setCommander(joyCommander);
+#ifdef USE_OPENGL
+    for (const QPixmap &px : pellsBawl->pixmaps()) textures.prime(px);
+#endif
 
     unpause();
 }
@@ -191,21 +294,30 @@ void Game::level3()
     pause(); clear(false); // keep pb
 
     // load level data.... (todo)
+    Bundles::mount(levelBundles(level));
 
     // Load platforms from a JSON file
     loadWorld("test.json", ":/assets/testlevel/");
 
     pellsBawl = new PellsBawl(this);
+    Archetypes::player(entities, pellsBawl);
     joyCommander = new PellsBawlCommander(this, pellsBawl);
     joystick->setCommander(joyCommander);
+#ifdef USE_OPENGL
+    for (const QPixmap &px : pellsBawl->pixmaps()) textures.prime(px);
+#endif
 
     fighter = new Fighter(this);
     fighter->loadFromJson(":/assets/mt2/mt2.json");
+#ifdef USE_OPENGL
+    for (const QPixmap &px : fighter->pixmaps()) textures.prime(px);
+#endif
 
     enemyCommander = new FighterCommander(this, fighter);
 
     fighterAI = new FighterAI(this);
     fighterAI->setCommander(enemyCommander);
+    Archetypes::fighter(entities, fighter, fighterAI);
 
     unpause();
 }
@@ -228,11 +340,21 @@ void Game::clear(bool pb){
     if (joyCommander) delete joyCommander;
     if (enemyCommander) delete enemyCommander;
     if (fighterAI) delete fighterAI;
-    enemies.clear();
+    entities.clear();
+    crumbs.clear();
+    triggers.clear();
+    scrolling = true;
     shapes.clear();
+    shapeIndex.clear();
     images.clear();
+    Symbol::endScope(); // the level's ids, after everything holding one
 
     animLayers.clear();
+    Assets::clearPrefetched();
+#ifdef USE_OPENGL
+    makeCurrent(); textures.clear(); doneCurrent();
+#endif
+    Bundles::unmountAll(); // the next level mounts its own
 }
 
 Game::~Game() { clear(true); }
@@ -262,11 +384,20 @@ void drawShape(QPainter& p, const Shape& it){
 
 void applyTransform(QPainter& p, const Transform& tf){ p.translate(tf.pos); p.rotate(tf.rotation); p.scale(tf.scaleX, tf.scaleY); }
 
-void drawImage(QPainter& p, const Image& s){
+// Level art goes through the texture stream when it can, so it is never
+// uploaded inside the frame it first shows up in.
+void Game::drawLevelImage(QPainter& p, const QImage& img, const QRectF& target){
+#ifdef USE_OPENGL
+    if (textures.draw(p, img, target)) return;
+#endif
+    p.drawImage(target, img);
+}
+
+void Game::drawImage(QPainter& p, const Image& s){
     if (s.img.isNull()) return;
     p.save(); applyTransform(p, s.tf);
-    QRectF r = QRectF(-s.img.width()/2.0, -s.img.height()/2.0, s.img.width(), s.img.height());
-    p.drawImage(r.topLeft(), s.img); // image not auto-scaled; transform applies scale
+    QRectF r = QRectF(-s.size.width()/2.0, -s.size.height()/2.0, s.size.width(), s.size.height());
+    drawLevelImage(p, s.img, r); // laid out at native size; transform applies scale
     p.restore();
 }
 
@@ -281,8 +412,8 @@ void Game::drawAnimationLayer(QPainter& p, ParallaxLayer& L, QPointF &m_camera)
   p.setRenderHint(QPainter::SmoothPixmapTransform, true);
 
   const qreal m_zoom = 1.0; //p.window().height() / p.viewport().height();
-  const QPixmap &px = L.image;
-  const QSizeF imgSize = px.size() * L.scale;
+  const QImage &px = L.image;
+  const QSizeF imgSize = L.size * L.scale; // native size, px may be decoded smaller
 
          // layer origin in WORLD space:
          // worldPos = off - camera * rate
@@ -298,7 +429,7 @@ void Game::drawAnimationLayer(QPainter& p, ParallaxLayer& L, QPointF &m_camera)
   const double h = std::max(1.0, imgSize.height() * m_zoom);
 
   if (L.scale == 0.0) {
-    p.drawPixmap(window.toRect(), px);
+    drawLevelImage(p, px, window.toRect());
 
     p.restore();
     return;
@@ -307,7 +438,7 @@ void Game::drawAnimationLayer(QPainter& p, ParallaxLayer& L, QPointF &m_camera)
   if (!L.wrap) {
     // Draw a single instance only
     QRectF target(originScreen, QSizeF(w, h));
-    p.drawPixmap(target.toRect(), px);
+    drawLevelImage(p, px, target.toRect());
 
     p.restore();
     return;
@@ -333,7 +464,7 @@ void Game::drawAnimationLayer(QPainter& p, ParallaxLayer& L, QPointF &m_camera)
     for (int xx = -1; xx < xTiles; ++xx) {
       const QPointF pos(originScreen.x() + xx * w, originScreen.y() + yy * h);
       QRectF target(pos, QSizeF(w, h));
-      p.drawPixmap(target.toRect(), px);
+      drawLevelImage(p, px, target.toRect());
     }
   }
 
@@ -342,6 +473,7 @@ void Game::drawAnimationLayer(QPainter& p, ParallaxLayer& L, QPointF &m_camera)
 
 #ifdef USE_OPENGL
 void Game::paintGL() {
+    textures.pump(defaultFramebufferObject());
 #else
 void Game::paintEvent(QPaintEvent *) {
 #endif
@@ -388,22 +520,17 @@ void Game::paintEvent(QPaintEvent *) {
     // for (const auto& it : shapes) drawShape(painter, it);
 
     // Draw enemies with the correct animation based on their state
-    for (const Enemy &enemy : enemies) {
-        if (!enemy.isDefeated) {
-            painter.drawPixmap(enemy.rect, enemy.alivePixmap); // Draw enemy when alive
-        } else {
-            painter.drawPixmap(enemy.rect, enemy.defeatedPixmap); // Draw enemy when defeated
-        }
-    }
+    Systems::paintSprites(entities, painter);
 
     // This includes shots and shadow
     if (pellsBawl) pellsBawl->paintWalker(painter, ground); //, playerRect, turningLeft, m_animTime); // Draw player character
+    paintCrumbs(painter);
 
     // Fighter (MT2)
     if (fighter) fighter->paint(&painter);
 
     // Draw foreground
-    for (const auto& s : images) drawImage(painter, s);
+    images.each([&](int, const Image &s) { drawImage(painter, s); });
 
     // Draw very foreground artifacts (parallax)
     for (auto &b : animLayers) if (b.z > 0) drawAnimationLayer(painter, b, scrollOffset);
@@ -422,37 +549,48 @@ void Game::paintEvent(QPaintEvent *) {
     painter.restore();
 }
 
-void Game::checkEnemyCollisions() {
-    QRectF rect = pellsBawl->playerRectangle();
-    for (Enemy &enemy : enemies) {
-        if (rect.intersects(enemy.rect)) {
-            if (!enemy.isDefeated) {
-                // If the player collides with an enemy, mark it as defeated
-                enemy.isDefeated = true;
-            }
-        }
+void Game::checkAreaCollisions() {
+    const QRectF player = pellsBawl->playerRectangle();
+    triggers.update(player, triggerEvents);
+    if (triggerEvents.isEmpty()) return;
+
+    Script::State s;
+    s.player = player.center();
+    s.velocity = QPointF(pellsBawl->velX(), pellsBawl->velY());
+    s.window = window;
+    s.scrolling = scrolling;
+    for (const TriggerEvent &e : triggerEvents) Script::run(triggers.program(), e.entry, s);
+
+    pellsBawl->setVelocity(s.velocity.x(), s.velocity.y());
+    window = s.window;
+    scrolling = s.scrolling;
+    if (s.walls >= 0) setWallsOpen(!s.walls);
+    if (s.nextLevel) nextLevel();
+}
 
-        // Move the enemy based on its platform
-        for (const Shape &shape : shapes) {
-            if (shape.rect.intersects(enemy.rect)) {
-                enemy.move(shape.rect.toRect());  // Move the enemy within its platform
-            }
-        }
-    }
+// ------------------------------
+// Level changes
+// ------------------------------
+Handle Game::spawnShape(const Shape &s) {
+    const Handle h = shapes.insert(s);
+    shapeIndex.insert(int(h.slot), s.rect);
+    return h;
 }
 
-void Game::checkAreaCollisions() {
-    QRectF rect = pellsBawl->playerRectangle();
-
-    for (const auto &area : areas) {
-        if (area.rect.intersects(rect)) {
-            if (area.title.contains("Knap")) {
-                for (auto &wall : shapes) if(wall.isWall) shapes.removeAll(wall);
-                for (auto &wall : images) if(wall.id.contains("Wall")) images.removeAll(wall);
-            }
-            if (area.title.contains("NextLevel")) nextLevel();
-        }
-    }
+void Game::removeShape(Handle h) {
+    if (shapes.remove(h)) shapeIndex.remove(int(h.slot));
+}
+
+void Game::setShapeEnabled(Handle h, bool enabled) {
+    if (shapes.setEnabled(h, enabled)) shapeIndex.setEnabled(int(h.slot), enabled);
+}
+
+// Walls are disabled rather than removed, so they can close again
+void Game::setWallsOpen(bool open) {
+    for (int i = 0; i < shapes.slotCount(); ++i)
+        if (shapes[i].isWall) setShapeEnabled(shapes.handle(i), !open);
+    for (int i = 0; i < images.slotCount(); ++i)
+        if (images[i].isWall) images.setEnabled(images.handle(i), !open);
 }
 
 // struct ProjectileInfo {
@@ -492,6 +630,14 @@ void Game::doFighterSense(double dt) {
     os.vel = QPointF(pellsBawl->velX(), pellsBawl->velY());
     os.onGround = !pellsBawl->jumping();
     os.facing = pellsBawl->faceLeft() ? Dir::Left : Dir::Right;
+    for (const Projectile &c : pellsBawl->cookies().projectiles()) {
+        if (c.state != Projectile::Flying) continue;
+        ProjectileInfo p;
+        p.pos = c.position();
+        p.vel = c.velocity();
+        if (c.scheduled) { p.impactIn = c.impactIn(); p.impactPos = c.impactPos(); }
+        os.activeProjectiles.append(p);
+    }
 
     struct SelfSnapshot ss = { fighter->pos(), fighter->vel(), fighter->onGround(), fighter->facing() };
 
@@ -519,6 +665,21 @@ void Game::doScrolling(double dt, bool twoPlayer = false) {
     }
 }
 
+// A few bits of dough thrown back off the surface, fanned around its normal
+void Game::paintCrumbs(QPainter &p) {
+    if (crumbs.isEmpty()) return;
+    p.save();
+    p.setPen(Qt::NoPen);
+    for (const CookieCrumb &c : crumbs) {
+        const double k = c.age / kCrumbSec;
+        p.setBrush(QColor(214, 173, 117, int(255 * (1.0 - k))));
+        const QPointF n = c.normal.isNull() ? QPointF(0, -1) : c.normal;
+        const QPointF t(-n.y(), n.x());
+        for (int i = -2; i <= 2; ++i) p.drawEllipse(c.pos + (n + t * (0.5 * i)) * (30.0 * k), 3.0, 3.0);
+    }
+    p.restore();
+}
+
 void Game::timerEvent(QTimerEvent *) {
     qint64 now = m_clock.elapsed();
     double dt = (now - m_lastMs) / 1000.0;
@@ -535,141 +696,271 @@ void Game::timerEvent(QTimerEvent *) {
     }
 
     // // Opponent movement
-    if (fighter) fighter->update(dt, shapes, bounds);
+    if (fighter) fighter->update(dt, shapes.slots(), shapeIndex, bounds);
 
     // Collisions
     if (pellsBawl) {
-        pellsBawl->checkCollisions(shapes, bounds);
-        checkEnemyCollisions();
+        pellsBawl->checkCollisions(shapes.slots(), shapeIndex, bounds);
+        for (const ProjectileHit &h : pellsBawl->cookies().hits())
+            if (h.shape >= 0) crumbs.push_back(CookieCrumb{ h.pos, h.normal, 0.0 });
+        Systems::syncActors(entities);
+        Systems::patrol(entities, shapes.slots(), shapeIndex, bounds);
+        Systems::integrate(entities);
+        Systems::contacts(entities);
         checkAreaCollisions();
     }
 
-    if (pellsBawl) doScrolling(dt);
+    if (pellsBawl && scrolling) doScrolling(dt);
+
+    for (CookieCrumb &c : crumbs) c.age += dt;
+    crumbs.erase(std::remove_if(crumbs.begin(), crumbs.end(), [](const CookieCrumb &c) { return c.age >= kCrumbSec; }),
+                 crumbs.end());
 
     update(); // Repaint the widget
 }
 
-// ---- JSON helpers ----
-static QPointF jsonToPoint(const QJsonValue& v){ QJsonObject o=v.toObject(); return QPointF(o.value("x").toDouble(), o.value("y").toDouble()); }
-static QRectF jsonToRect(const QJsonValue& v){ QJsonObject o=v.toObject(); return QRectF(o.value("x").toDouble(), o.value("y").toDouble(), o.value("w").toDouble(), o.value("h").toDouble()); }
+// The editor stores absolute paths. tools/manifest resolves them at bake time;
+// levels that aren't baked yet fall back to trying the base path, the level
+// path and the bare file name in turn, first one that exists wins.
+static QString resolveImagePath(const QString &basePath, const QString &imagePath, const QString &levelPath) {
+    const QString baked = Assets::resolve(levelPath, imagePath);
+    if (!baked.isEmpty()) return baked;
+    if (Assets::hasManifest()) qWarning() << "not in manifest, probing:" << levelPath << imagePath;
+
+    const QString name = imagePath.split("/").last();
+    for (const QString &candidate : { basePath + imagePath, basePath + name, levelPath + imagePath, levelPath + name, imagePath })
+        if (Assets::exists(candidate)) return candidate;
+    return QString();
+}
+
+// ------------------------------
+// Decode sizes. The painter maps the level's window rect onto the widget, so a
+// level pixel covers viewScale device pixels; art is decoded at the size it
+// ends up covering on screen (never above native, see Assets::loadImage).
+// ------------------------------
+static qreal viewScale(const QRectF &window, const QSizeF &viewport) {
+    if (window.isEmpty() || viewport.isEmpty()) return 1.0;
+    return qMax(viewport.width() / window.width(), viewport.height() / window.height());
+}
+
+static QSize decodeSize(const QSize &native, qreal sx, qreal sy) {
+    if (!native.isValid()) return QSize();
+    return QSize(qCeil(native.width() * qAbs(sx)), qCeil(native.height() * qAbs(sy)));
+}
+
+static QSize graphicDecodeSize(const QSize &native, const Transform &tf, qreal view) {
+    return decodeSize(native, tf.scaleX * view, tf.scaleY * view);
+}
+
+static QSize parallaxDecodeSize(const QSize &native, double scale, const QSizeF &viewport, qreal view) {
+    if (scale == 0.0) return viewport.toSize(); // stretched over the window
+    return decodeSize(native, scale * view, scale * view);
+}
 
-QList<Area> loadAreas(const QJsonDocument& doc){
+static QList<Assets::Request> levelAssetRequests(const QString &filename, const QString &path, const QSizeF &viewport) {
+    QList<Assets::Request> requests;
+    QFile file(path + filename);
+    if (!file.open(QIODevice::ReadOnly)) return requests;
+
+    Symbol::beginScope(); // the level's ids are only needed here
+    LevelData level;
+    if (!readLevel(file.readAll(), level)) { Symbol::endScope(); return requests; }
+    const qreal view = viewScale(level.window, viewport);
+    for (const Image &s : level.images) {
+        const QString resolved = resolveImagePath(level.basePath, s.path.toString(), path);
+        if (resolved.isEmpty()) continue;
+        requests << Assets::Request{resolved, graphicDecodeSize(Assets::imageSize(resolved), s.tf, view)};
+    }
+    for (const LevelParallax &l : level.parallax) {
+        const QString image = path + l.image;
+        requests << Assets::Request{image, parallaxDecodeSize(Assets::imageSize(image), l.scale, viewport, view)};
+    }
+    level = LevelData();
+    Symbol::endScope();
+    return requests;
+}
+
+// Widget size in device pixels
+QSizeF Game::viewportSize() const {
+    return QSizeF(size()) * devicePixelRatioF();
+}
+
+// Resolve, size and decode one level graphic; false if it has no art.
+static bool loadImageArt(Image &s, const QString &basePath, const QString &path, qreal view) {
+    const QString resolved = resolveImagePath(basePath, s.path.toString(), path);
+    if (resolved.isEmpty()) return false;
+    s.isWall = s.id.toString().contains("Wall");
+    s.size = Assets::imageSize(resolved);
+    Assets::loadImage(s.img, resolved, graphicDecodeSize(s.size.toSize(), s.tf, view));
+    return !s.img.isNull();
+}
+
+static void loadParallaxArt(ParallaxLayer &g, const QString &image, const QSizeF &viewport, qreal view) {
+    g.size = Assets::imageSize(image);
+    g.image = Assets::loadImage(image, parallaxDecodeSize(g.size.toSize(), g.scale, viewport, view));
+    qDebug() << g.size << "decoded" << g.image.size();
+}
+
+// ------------------------------
+// Compiled levels (tools/levelc, levelformat.h). The build regenerates each
+// level's .pbl from its JSON into levels/ next to the executable (see
+// platformer.pro), so one never stands in for a newer edit. It is used
+// instead of the JSON: the file is mapped and the records read in place.
+// ------------------------------
+static QString compiledLevelFile(const QString &path, const QString &filename) {
+    QString rel = path + QFileInfo(filename).completeBaseName() + ".pbl";
+    if (rel.startsWith(":/")) rel.remove(0, 2);
+    const QString dir = QCoreApplication::applicationDirPath();
+    for (const QString &candidate : { dir + "/levels/" + rel,
+                                      dir + "/../Resources/levels/" + rel }) // macOS app bundle
+        if (QFile::exists(candidate)) return candidate;
+    return QString();
+}
+
+bool Game::loadCompiledWorld(const QString &file, const QString &path) {
+    QFile f(file);
+    if (file.isEmpty() || !f.open(QIODevice::ReadOnly)) return false;
+    // Records hold doubles, so the data has to start 8-byte aligned; a file
+    // mapping always does. Should mapping fail the file is read into an
+    // aligned copy instead.
+    QVector<quint64> copy;
+    const uchar *data = f.map(0, f.size());
+    if (data && quintptr(data) % 8) { f.unmap(const_cast<uchar *>(data)); data = nullptr; }
+    if (!data) {
+        copy.resize((f.size() + 7) / 8);
+        if (f.read(reinterpret_cast<char *>(copy.data()), f.size()) != f.size()) return false;
+        data = reinterpret_cast<const uchar *>(copy.constData());
+    }
+
+    const LevelFormat::View lv(data, f.size());
+    if (!lv.valid()) { qWarning() << "stale or broken compiled level" << file; return false; }
+    const LevelFormat::Header &h = lv.header();
+
+    world = LevelFormat::toRect(h.world);
+    window = LevelFormat::toRect(h.window);
+    bounds = world;
+
+    shapes.reserve(h.shapes.count);
+    for (const auto *s = lv.shapes(), *e = s + h.shapes.count; s != e; ++s) {
+        Shape it; it.id = Symbol::intern(lv.string(s->id));
+        it.shape = s->kind == LevelFormat::Rect ? Shape::Rect : (s->kind == LevelFormat::TriLeft ? Shape::TriLeft : Shape::TriRight);
+        it.isWall = s->isWall;
+        it.rect = LevelFormat::toRect(s->rect);
+        shapes.insert(it);
+    }
+    if (!shapeIndex.adopt(shapes.slots(), lv)) shapeIndex.build(shapes.slots());
     QList<Area> areas;
-    QJsonObject root = doc.object();
-    for (auto v : root.value("areas").toArray()){
-        QJsonObject o=v.toObject();
-        Area ar; ar.id = o.value("id").toString("dummy");
-        ar.title = o.value("title").toString("øf");
-        ar.rect = jsonToRect(o.value("rect"));
+    areas.reserve(h.areas.count);
+    for (const auto *a = lv.areas(), *e = a + h.areas.count; a != e; ++a) {
+        Area ar; ar.id = Symbol::intern(lv.string(a->id)); ar.title = lv.string(a->title); ar.script = lv.string(a->script);
+        ar.rect = LevelFormat::toRect(a->rect);
         areas.push_back(ar);
     }
-    return areas;
-}
-
-QList<Shape> loadShapes(const QJsonDocument& doc){
-    QList<Shape> shapes;
-    QJsonObject root = doc.object();
-    for (auto v : root.value("interaction").toArray()){
-        QJsonObject o=v.toObject();
-        Shape it; it.id = o.value("id").toString("dummy");
-        it.shape = o.value("shape").toString("rect") == "rect" ? Shape::Rect : (o.value("shape").toString() == "tri_left" ? Shape::TriLeft : Shape::TriRight);
-        it.isWall = o.value("is_wall").toBool(false);
-        it.rect = jsonToRect(o.value("rect"));
-        shapes.push_back(it);
+    triggers.load(areas);
+    QList<EnemySpawn> spawns;
+    for (const auto *r = lv.enemies(), *e = r + h.enemies.count; r != e; ++r)
+        spawns.push_back(EnemySpawn{ lv.string(r->type), QPointF(r->x, r->y), bool(r->facingLeft) });
+    spawnEnemies(spawns);
+
+    const QSizeF viewport = viewportSize();
+    const qreal view = viewScale(window, viewport);
+    const QString basePath = lv.string(h.basePath);
+    images.reserve(h.images.count);
+    for (const auto *r = lv.images(), *e = r + h.images.count; r != e; ++r) {
+        Image s; s.id = Symbol::intern(lv.string(r->id));
+        s.path = Symbol::intern(lv.string(r->path));
+        s.z = r->z;
+        s.tf.pos = QPointF(r->x, r->y);
+        s.tf.rotation = r->rotation;
+        s.tf.scaleX = r->scaleX;
+        s.tf.scaleY = r->scaleY;
+        if (loadImageArt(s, basePath, path, view)) images.insert(s);
     }
-    return shapes;
-}
-
-QList<Image> loadImages(const QJsonDocument& doc, const QString &path){
-    QList<Image> images;
-    QJsonObject root = doc.object();
-    QString basePath = root.value("basePath").toString(":assets/");
-    for (auto v : root.value("graphics").toArray()){
-        QJsonObject o = v.toObject();
-        Image s; s.id = o.value("id").toString();
-        s.path = o.value("path").toString();
-        s.z = o.value("z").toDouble(0);
-        s.tf.pos = jsonToPoint(o.value("pos"));
-        s.tf.rotation=o.value("rotation").toDouble(0);
-        s.tf.scaleX=o.value("scaleX").toDouble(1.0);
-        s.tf.scaleY=o.value("scaleY").toDouble(1.0);
-        if (!s.img.load(basePath + s.path))
-            if(!s.img.load(basePath + s.path.split("/").last()))
-                if (!s.img.load(path + s.path))
-                    if(!s.img.load(path + s.path.split("/").last()))
-                        s.img.load(s.path);
-        if (!s.img.isNull()) images.push_back(s);
+    animLayers.reserve(h.parallax.count);
+    for (const auto *r = lv.parallax(), *e = r + h.parallax.count; r != e; ++r) {
+        ParallaxLayer g;
+        g.off = QPointF(r->offX, r->offY);
+        g.rate = QPointF(r->rateX, r->rateY);
+        g.scale = r->scale;
+        g.z = r->z;
+        g.wrap = r->wrap;
+        loadParallaxArt(g, path + lv.string(r->image), viewport, view);
+        animLayers.append(g);
     }
-    return images;
+    qDebug() << "compiled level" << file << "shapes:" << shapes.size() << "images:" << images.size();
+    return true;
+}
+
+// Level art goes to the texture stream as soon as it is decoded
+void Game::streamLevelArt() {
+#ifdef USE_OPENGL
+    images.each([&](int, const Image &s) { textures.enqueue(s.img); });
+    for (const auto &l : animLayers) textures.enqueue(l.image);
+#endif
+}
+
+void Game::spawnEnemies(const QList<EnemySpawn> &spawns) {
+    for (const EnemySpawn &s : spawns)
+        if (const EnemyType *type = enemyTypes.find(s.type)) Archetypes::enemy(entities, type, s.pos, s.facingLeft);
 }
 
 void Game::loadWorld(const QString &filename, const QString &path) {
+    Symbol::beginScope(); // ended by clear()
+    if (loadCompiledWorld(compiledLevelFile(path, filename), path)) {
+        streamLevelArt();
+        return;
+    }
+
     QFile file(path + filename);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning("Couldn't open platforms file.");
         return;
     }
 
-    QByteArray data = file.readAll();
+    const QByteArray data = file.readAll();
     qDebug() << "data:" << data.size();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-
-    QJsonObject root = doc.object();
-    qDebug() << root.isEmpty();
-    if(!root.empty()) {
-        auto i = root.value("interaction").toArray();
-        qDebug() << i.isEmpty();
-        if(!i.empty()) {
-            areas = loadAreas(doc);
-
-            shapes = loadShapes(doc);
-            qDebug() << "shapes:" << shapes.size();
-            images = loadImages(doc, path);
-            qDebug() << "images:" << images.size();
-
-            world = jsonToRect(root.value("world"));
-            qDebug() << "world:" << world;
-            window = jsonToRect(root.value("window"));
-            qDebug() << "window:" << window;
-            bounds = world;
-
-            auto p = root.value("parallax").toArray();
-            for (auto l: p) {
-                ParallaxLayer g;
-                auto o = l.toObject();
-                g.image.load(path + o.value("image").toString());
-                qDebug() << g.image.rect();
-                auto a = o.value("off").toArray(); g.off = QPointF(a.at(0).toDouble(0.0), a.at(1).toDouble(0.0));
-                a = o.value("rate").toArray(); g.rate = QPointF(a.at(0).toDouble(0.0), a.at(1).toDouble(0.0));
-                g.scale = o.value("scale").toDouble();
-                g.z = o.value("z").toInt();
-                g.wrap = o.value("wrap").toBool();
-                animLayers.append(g);
-            }
-        } else { //legacy
-            QJsonArray a = root["world"].toArray();
-            world.setRect(a.at(0).toInt(), a.at(1).toInt(), a.at(2).toInt(), a.at(3).toInt());
-
-            a = root["bounds"].toArray();
-            bounds.setRect(a.at(0).toInt(), a.at(1).toInt(), a.at(2).toInt(), a.at(3).toInt());
-
-            ground = root["ground"].toInt(550);
-
-            QJsonArray platformArray = root["platforms"].toArray();
-
-            // Ground platform
-            // platforms.append(Platform(0, height() - 50, width(), 50, true));
-
-            // Read platforms from the JSON file
-            for (const QJsonValue &value : platformArray) {
-                QJsonObject obj = value.toObject();
-                int x = obj["x"].toInt();
-                int y = obj["y"].toInt();
-                int w = obj["width"].toInt();
-                int h = obj["height"].toInt();
-                Shape f; f.rect = QRect(x,y,w,h);
-                shapes.append(f);
-            }
-        }
+    LevelData level;
+    QString err;
+    if (!readLevel(data, level, &err)) {
+        qWarning() << "Couldn't read" << filename << err;
+        return;
+    }
+
+    world = level.world;
+    qDebug() << "world:" << world;
+    bounds = level.bounds;
+    shapes.reserve(level.shapes.size());
+    for (const Shape &s : level.shapes) shapes.insert(s);
+    shapeIndex.build(shapes.slots());
+    qDebug() << "shapes:" << shapes.size();
+    if (level.legacy) {
+        ground = level.ground;
+        return;
     }
+
+    triggers.load(level.areas);
+    spawnEnemies(level.enemies);
+    window = level.window;
+    qDebug() << "window:" << window;
+
+    const QSizeF viewport = viewportSize();
+    const qreal view = viewScale(window, viewport);
+    images.reserve(level.images.size());
+    animLayers.reserve(level.parallax.size());
+    for (Image &s : level.images)
+        if (loadImageArt(s, level.basePath, path, view)) images.insert(s);
+    qDebug() << "images:" << images.size();
+
+    for (const LevelParallax &l : level.parallax) {
+        ParallaxLayer g;
+        g.off = l.off;
+        g.rate = l.rate;
+        g.scale = l.scale;
+        g.z = l.z;
+        g.wrap = l.wrap;
+        loadParallaxArt(g, path + l.image, viewport, view);
+        animLayers.append(g);
+    }
+
+    streamLevelArt();
 }
@@ -16,44 +16,19 @@
 
 #include <QScreen>
 #include "commander.h"
+#include "entities.h"
 #include "pellsBawl.h"
+#include "shapeindex.h"
+#include "slotmap.h"
 #include "fighterAI.h"
 #include "joystick.h"
-
-struct Enemy {
-    QRect rect;
-    bool isDefeated;
-    bool movingLeft;
-    int velocityX;
-    QPixmap alivePixmap;
-    QPixmap defeatedPixmap;
-
-    Enemy(int x, int y, int w, int h)
-        : rect(x, y, w, h), isDefeated(false), movingLeft(true), velocityX(2) {
-        // Load the enemy images
-        alivePixmap.load(":/assets/testlevel/enemy_sad.png");   // Image when alive
-        defeatedPixmap.load(":/assets/testlevel/enemy_happy.png"); // Image when defeated
-        
-    }
-
-    void move(const QRect &platform) {
-        // Move the enemy left or right within the platform bounds
-        if (movingLeft) {
-            rect.moveLeft(rect.left() - velocityX);
-            if (rect.left() <= platform.left()) { // If at the left edge of the platform
-                movingLeft = false;
-            }
-        } else {
-            rect.moveLeft(rect.left() + velocityX);
-            if (rect.right() >= platform.right()) { // If at the right edge of the platform
-                movingLeft = true;
-            }
-        }
-    }
-};
+#include "startup.h"
+#include "texturestream.h"
+#include "triggers.h"
 
 struct ParallaxLayer {
-    QPixmap image;
+    QImage image;
+    QSizeF size;    // native size, image may be decoded smaller
     QPointF off = {0.0, 0.0}, rate = {0.0,0.0};
     double scale = 1.0;
     int z = -2;
@@ -93,6 +68,7 @@ protected:
     void keyPressEvent(QKeyEvent *event) override;
     // void keyReleaseEvent(QKeyEvent *event) override;
 #ifdef USE_OPENGL
+    void initializeGL() override;
     void paintGL() override;
 #else
     void paintEvent(QPaintEvent *event) override;
@@ -101,12 +77,27 @@ protected:
 
 private:
 
+    void startupBehindSplash();
+#ifdef USE_OPENGL
+    void warmUpPaintEngine();
+#endif
     void loadWorld(const QString &file, const QString &path);
+    bool loadCompiledWorld(const QString &file, const QString &path);
+    void streamLevelArt();
+    void spawnEnemies(const QList<EnemySpawn> &spawns);
+    // Level changes while it runs, O(1) each
+    Handle spawnShape(const Shape &s);
+    void removeShape(Handle h);
+    void setShapeEnabled(Handle h, bool enabled);
+    void setWallsOpen(bool open);
     void doFighterSense(double dt);
-    void checkEnemyCollisions();
     void checkAreaCollisions();
     void doScrolling(double dt, bool twoPlayer);
     void drawAnimationLayer(QPainter &p, ParallaxLayer &l, QPointF &scrollOffset);
+    void drawImage(QPainter &p, const Image &s);
+    void drawLevelImage(QPainter &p, const QImage &img, const QRectF &target);
+    void paintCrumbs(QPainter &p);
+    QSizeF viewportSize() const;
 
     void setScreenSleepBlock(bool enable);
     bool m_screenSleepBlocked = false;
@@ -141,12 +132,25 @@ private:
     QMediaPlayer* player;
     QAudioOutput* audio;
 
-    PellsBawl *pellsBawl = nullptr;
-    QList<Enemy> enemies;
+    Startup *startup = nullptr;
+#ifdef USE_OPENGL
+    TextureStream textures;
+#endif
 
-    QList<Area> areas;
-    QList<Shape> shapes;
-    QList<Image> images;
+    PellsBawl *pellsBawl = nullptr;
+    EntityWorld entities;   // enemies, and PellsBawl/Fighter as actors
+    // Where cookies landed, from the pool's hits; drawn for kCrumbSec
+    struct CookieCrumb { QPointF pos, normal; double age; };
+    static constexpr double kCrumbSec = 0.35;
+    QVector<CookieCrumb> crumbs;
+    EnemyTypes enemyTypes;  // kept across levels
+
+    Triggers triggers;      // the level's areas
+    QVector<TriggerEvent> triggerEvents;
+    bool scrolling = true;  // scripts can hold the window still
+    SlotMap<Shape> shapes;
+    ShapeIndex shapeIndex; // built at load, kept in step by the calls below
+    SlotMap<Image> images;
     QRectF world = {0, 0, 1800, 1200};
     QRectF window = {0, 0, 800, 600};
     QRectF bounds = {0, 0, 800, 600};
@@ -0,0 +1,104 @@
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <QtGlobal>
+#include <QPointF>
+#include <cmath>
+
+// ------------------------------
+// Procedural rig animation as constexpr data. tools/animc compiles the
+// animation JSON into tables of these at build time (pellsBawlAnim.h);
+// nothing is parsed or looked up by name at runtime.
+// ------------------------------
+
+struct Curve {
+    enum Type { Const, Sine, Linear } type = Const;
+
+    // const
+    double value = 0.0;
+
+    // sine
+    double amp = 0.0, phaseRad = 0.0, bias = 0.0;
+
+    // linear
+    double start = 0.0, end = 0.0;
+
+    double eval(double t, double duration) const {
+        switch (type) {
+        case Const:
+            return value;
+        case Sine: {
+            const double omega = (duration > 0.0) ? (2.0 * M_PI / duration) : 0.0;
+            return amp * std::sin(omega * t + phaseRad) + bias;
+        }
+        case Linear: {
+            if (duration <= 0.0) return end;            // safe fallback
+            const double u = t / duration;               // 0..1 over the clip
+            return start + (end - start) * u;
+        }
+        }
+        return 0.0;
+    }
+};
+
+namespace Anim {
+
+constexpr Curve constant(double value) { return Curve{ Curve::Const, value, 0.0, 0.0, 0.0, 0.0, 0.0 }; }
+constexpr Curve sine(double amp, double phaseDeg, double bias) {
+    return Curve{ Curve::Sine, 0.0, amp, phaseDeg * M_PI / 180.0, bias, 0.0, 0.0 };
+}
+constexpr Curve linear(double start, double end) { return Curve{ Curve::Linear, 0.0, 0.0, 0.0, 0.0, start, end }; }
+
+// How paintWalker places a track, decided from the part id at build time
+enum Motion : quint8 {
+    Body,   // its curves drive the whole rig (bob, sway)
+    Foot,   // walk cycle on the foot capsule, footPhase apart
+    Part    // own curves, riding on the body bob
+};
+
+struct TrackDef {
+    quint8 role;             // index into the generated Role enum
+    Motion motion;
+    double footPhase;        // Foot: 0 for left, 0.5 for right
+    double w, h;             // desired size in logical px, 0 = natural
+    double baseX, baseY;
+    Curve x, y, rot;
+    int zOrder;
+};
+
+// Tracks are stored in draw order (stable by zOrder)
+struct ClipDef {
+    const char *id;
+    double durationSec;
+    bool loop, useFootCapsule;
+    const TrackDef *tracks;
+    int trackCount;
+    int body;                // index of the Body track, -1 if none
+};
+
+// Body-local pose of a rig, one slot per role. Clips are evaluated into a
+// pose each frame and cross-fades blend two of them in place.
+template<int Roles>
+struct Pose {
+    QPointF pos[Roles];
+    double rot[Roles] = {};
+    quint32 present = 0;     // bit per role
+    double bodyBob = 0.0;
+};
+
+// to = mix(from, to, w) for the roles both poses have; rotations take the
+// short way round (a finished spin at 360 fades to 0 without unwinding)
+template<int Roles>
+void blendInto(Pose<Roles> &to, const Pose<Roles> &from, double w) {
+    const quint32 both = to.present & from.present;
+    for (int r = 0; r < Roles; ++r) {
+        if (!(both & (1u << r))) continue;
+        to.pos[r] = from.pos[r] + (to.pos[r] - from.pos[r]) * w;
+        to.rot[r] = from.rot[r] + std::remainder(to.rot[r] - from.rot[r], 360.0) * w;
+    }
+    to.bodyBob = from.bodyBob + (to.bodyBob - from.bodyBob) * w;
+}
+
+}
+
+#endif // ANIM_H
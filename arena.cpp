@@ -0,0 +1,45 @@
+#include <QtGlobal>
+#include <cstring>
+#include <new>
+
+#include "arena.h"
+
+void *Arena::allocate(size_t size, size_t align) {
+    // Chunks come from operator new, aligned for anything up to max_align_t
+    Q_ASSERT(align && align <= alignof(std::max_align_t) && !(align & (align - 1)));
+    while (true) {
+        if (m_current >= 0) {
+            Chunk &c = m_chunks[m_current];
+            const size_t at = (c.used + align - 1) & ~(align - 1);
+            if (at + size <= c.size) {
+                c.used = at + size;
+                return c.data + at;
+            }
+        }
+        if (m_current + 1 < m_chunks.size()) {
+            m_chunks[++m_current].used = 0;
+            continue;
+        }
+        const size_t n = qMax(m_chunkSize, size + align);
+        m_chunks.push_back(Chunk{ static_cast<char *>(::operator new(n)), n, 0 });
+        m_current = m_chunks.size() - 1;
+    }
+}
+
+QStringView Arena::copy(QStringView s) {
+    if (s.isEmpty()) return QStringView();
+    char16_t *p = allocate<char16_t>(s.size());
+    std::memcpy(p, s.utf16(), size_t(s.size()) * sizeof(char16_t));
+    return QStringView(p, s.size());
+}
+
+void Arena::rewind(const Mark &m) {
+    m_current = m.chunk;
+    if (m_current >= 0) m_chunks[m_current].used = m.used;
+}
+
+void Arena::release() {
+    for (const Chunk &c : m_chunks) ::operator delete(c.data);
+    m_chunks.clear();
+    m_current = -1;
+}
@@ -0,0 +1,54 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QStringView>
+#include <QVector>
+#include <cstddef>
+#include <type_traits>
+
+// ------------------------------
+// Bump allocator for data that dies all at once. Allocations carve from
+// large chunks; nothing is freed on its own. rewind() drops everything since
+// a mark() and keeps the chunks for what comes next, so a level loaded after
+// another of about the same size allocates nothing from the heap.
+//
+//   const Arena::Mark level = arena.mark();
+//   QStringView id = arena.copy(text);
+//   ...
+//   arena.rewind(level);                 // the whole level in one go
+//
+// Only for trivially destructible types: no destructor ever runs. Not
+// thread safe.
+// ------------------------------
+class Arena {
+public:
+    struct Mark { int chunk = -1; size_t used = 0; };
+
+    explicit Arena(size_t chunkSize = 64 * 1024) : m_chunkSize(chunkSize) {}
+    ~Arena() { release(); }
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    template<class T> T *allocate(qsizetype n) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destructed");
+        return static_cast<T *>(allocate(sizeof(T) * size_t(n), alignof(T)));
+    }
+
+    QStringView copy(QStringView s);
+
+    Mark mark() const { return Mark{ m_current, m_current >= 0 ? m_chunks[m_current].used : 0 }; }
+    void rewind(const Mark &m);
+    // Gives every chunk back to the heap
+    void release();
+
+private:
+    struct Chunk { char *data; size_t size, used; };
+
+    QVector<Chunk> m_chunks;
+    int m_current = -1;          // chunks after it are free, kept for reuse
+    size_t m_chunkSize;
+};
+
+#endif // ARENA_H
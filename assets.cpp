@@ -0,0 +1,228 @@
+#include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QImageReader>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <QtConcurrent>
+
+#include "assets.h"
+#include "diskcache.h"
+#include "qoi.h"
+
+namespace {
+
+QMutex cacheLock;
+QHash<QString, QImage> prefetched; // cacheKey() -> decoded image
+
+QString cacheKey(const QString &path, const QSize &maxSize) {
+    if (!maxSize.isValid()) return path;
+    return path + QString("@%1x%2").arg(maxSize.width()).arg(maxSize.height());
+}
+
+// ------------------------------
+// Baked manifest (tools/manifest): level image ids -> resource path, and the
+// native size of each image. The build rebakes it into manifest.json next to
+// the executable whenever a .qrc, a level or any art changes (platformer.pro).
+// Loaded once, on first use, from any thread.
+// ------------------------------
+struct Manifest {
+    QHash<QString, QString> ids;
+    QHash<QString, QSize> sizes;
+    bool loaded = false;
+};
+
+const Manifest &manifest() {
+    static const Manifest m = [] {
+        Manifest m;
+        const QString dir = QCoreApplication::applicationDirPath();
+        QFile f(dir + "/manifest.json");
+        if (!f.exists()) f.setFileName(dir + "/../Resources/manifest.json"); // macOS app bundle
+        if (!f.open(QIODevice::ReadOnly)) return m;
+        const QJsonObject root = QJsonDocument::fromJson(f.readAll()).object();
+        const QJsonObject ids = root.value("ids").toObject();
+        for (auto it = ids.begin(); it != ids.end(); ++it) m.ids.insert(it.key(), it.value().toString());
+        const QJsonObject assets = root.value("assets").toObject();
+        for (auto it = assets.begin(); it != assets.end(); ++it) {
+            const QJsonObject a = it.value().toObject();
+            m.sizes.insert(it.key(), QSize(a.value("w").toInt(), a.value("h").toInt()));
+        }
+        m.loaded = true;
+        qDebug() << "assets: manifest with" << m.ids.size() << "ids";
+        return m;
+    }();
+    return m;
+}
+
+// A converted .qoi next to the file (or the file itself) takes precedence.
+QString qoiFor(const QString &path) {
+    if (path.endsWith(".qoi", Qt::CaseInsensitive)) return QFile::exists(path) ? path : QString();
+    const QFileInfo fi(path);
+    const QString qoi = fi.path() + '/' + fi.completeBaseName() + ".qoi";
+    return QFile::exists(qoi) ? qoi : QString();
+}
+
+QString sourceFor(const QString &path) {
+    const QString qoi = qoiFor(path);
+    return qoi.isEmpty() ? path : qoi;
+}
+
+QImage decodeQoi(const QString &path, const QSize &maxSize) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QImage();
+    QImage img = Qoi::decode(f.readAll());
+    if (img.isNull() || !maxSize.isValid()) return img;
+    const QSize target = img.size().boundedTo(maxSize.expandedTo(QSize(1, 1)));
+    if (target == img.size()) return img;
+    return img.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+// Decode to the format QPainter blends fastest, so the conversion happens
+// on whatever thread did the decode and never on first draw.
+QImage decodeUncached(const QString &path, const QSize &maxSize) {
+    if (path.endsWith(".qoi", Qt::CaseInsensitive)) return decodeQoi(path, maxSize);
+    QImageReader reader(path);
+    if (maxSize.isValid()) {
+        const QSize native = reader.size();
+        const QSize target = native.boundedTo(maxSize.expandedTo(QSize(1, 1)));
+        if (native.isValid() && target != native) reader.setScaledSize(target);
+    }
+    QImage img = reader.read();
+    if (img.isNull()) return img;
+    const QImage::Format fmt = img.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                     : QImage::Format_RGB32;
+    if (img.format() != fmt) img.convertTo(fmt);
+    return img;
+}
+
+QByteArray sizeParams(const QSize &maxSize) {
+    return maxSize.isValid() ? QString("scaled=%1x%2").arg(maxSize.width()).arg(maxSize.height()).toLatin1()
+                             : QByteArray("native");
+}
+
+// Processed pixels come from the disk cache when they can; a miss decodes
+// and fills it for the next launch.
+QImage decode(const QString &path, const QSize &maxSize) {
+    const QString src = sourceFor(path);
+    const QByteArray key = DiskCache::key(src, sizeParams(maxSize));
+    QImage img;
+    if (DiskCache::load(key, img)) return img;
+    img = decodeUncached(src, maxSize);
+    DiskCache::store(key, img);
+    return img;
+}
+
+}
+
+namespace Assets {
+
+QString resolve(const QString &levelPath, const QString &imagePath) {
+    return manifest().ids.value(levelPath + '|' + imagePath);
+}
+
+bool hasManifest() {
+    return manifest().loaded;
+}
+
+QSize imageSize(const QString &path) {
+    auto it = manifest().sizes.constFind(path);
+    if (it != manifest().sizes.constEnd()) return it.value();
+    const QString qoi = qoiFor(path);
+    if (qoi.isEmpty()) return QImageReader(path).size();
+    QFile f(qoi);
+    return f.open(QIODevice::ReadOnly) ? Qoi::size(f.read(14)) : QSize();
+}
+
+bool exists(const QString &path) {
+    return QFile::exists(path) || !qoiFor(path).isEmpty();
+}
+
+QImage loadImage(const QString &path, const QSize &maxSize) {
+    {
+        QMutexLocker lock(&cacheLock);
+        auto it = prefetched.constFind(cacheKey(path, maxSize));
+        if (it != prefetched.constEnd()) return it.value();
+    }
+    return decode(path, maxSize);
+}
+
+bool loadImage(QImage &img, const QString &path, const QSize &maxSize) {
+    img = loadImage(path, maxSize);
+    return !img.isNull();
+}
+
+QPixmap loadPixmap(const QString &path, const QSize &maxSize) {
+    return QPixmap::fromImage(loadImage(path, maxSize));
+}
+
+QImage trimmed(const QImage &img, QPoint *origin) {
+    if (origin) *origin = QPoint(0, 0);
+    if (img.isNull() || !img.hasAlphaChannel()) return img;
+
+    QImage src = img;
+    if (src.format() != QImage::Format_ARGB32_Premultiplied && src.format() != QImage::Format_ARGB32)
+        src = src.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const int w = src.width(), h = src.height();
+    auto rowAlpha = [&](int y, int &first, int &last) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(src.constScanLine(y));
+        first = 0; while (first < w && qAlpha(line[first]) == 0) ++first;
+        if (first == w) return false;
+        last = w - 1; while (qAlpha(line[last]) == 0) --last;
+        return true;
+    };
+
+    int top = -1, bottom = -1, left = w, right = -1;
+    for (int y = 0; y < h; ++y) {
+        int first, last;
+        if (!rowAlpha(y, first, last)) continue;
+        if (top < 0) top = y;
+        bottom = y;
+        left = qMin(left, first);
+        right = qMax(right, last);
+    }
+    if (top < 0) return img.copy(0, 0, 1, 1); // fully transparent
+
+    const QRect box = QRect(QPoint(left, top), QPoint(right, bottom)).adjusted(-1, -1, 1, 1) & src.rect();
+    if (box == src.rect()) return img;
+    if (origin) *origin = box.topLeft();
+    return src.copy(box);
+}
+
+QImage loadTrimmed(const QString &path, QPoint *origin) {
+    const QString src = sourceFor(path);
+    const QByteArray key = DiskCache::key(src, "trimmed");
+    QImage img;
+    if (DiskCache::load(key, img, origin)) return img;
+    QPoint crop;
+    img = trimmed(decodeUncached(src, QSize()), &crop);
+    DiskCache::store(key, img, crop);
+    if (origin) *origin = crop;
+    return img;
+}
+
+void prefetch(const QList<Request> &requests) {
+    QtConcurrent::blockingMap(QList<Request>(requests), [](const Request &r) {
+        if (isPrefetched(r.path, r.maxSize)) return;
+        QImage img = decode(r.path, r.maxSize);
+        if (img.isNull()) return;
+        QMutexLocker lock(&cacheLock);
+        prefetched.insert(cacheKey(r.path, r.maxSize), img);
+    });
+}
+
+bool isPrefetched(const QString &path, const QSize &maxSize) {
+    QMutexLocker lock(&cacheLock);
+    return prefetched.contains(cacheKey(path, maxSize));
+}
+
+void clearPrefetched() {
+    QMutexLocker lock(&cacheLock);
+    prefetched.clear();
+}
+
+}
@@ -0,0 +1,64 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSize>
+
+// ------------------------------
+// Image loading shared by the game, the fighters and the PellsBawl rig.
+// Decoding happens on QImage (thread safe), so anything can be prefetched on
+// the thread pool and picked up later from the main thread without a decode.
+//
+// A .qoi file next to a .png/.jpg (see qoi.h) is used in its place, so
+// converted assets need no changes at the call sites.
+//
+// A maxSize (per axis, device pixels) decodes straight to the size the image
+// is actually shown at; JPEGs then scale inside the decoder. Callers draw into
+// a target rect, so they keep using the native size for layout.
+// ------------------------------
+namespace Assets {
+
+struct Request {
+    QString path;
+    QSize maxSize; // invalid = native size
+};
+
+// Resource path of an image as written in a level under levelPath, from the
+// baked manifest (tools/manifest, manifest.json next to the executable);
+// empty if unknown.
+QString resolve(const QString &levelPath, const QString &imagePath);
+bool hasManifest();
+
+// Native size from the manifest or the file header, without decoding
+QSize imageSize(const QString &path);
+// The file or its converted .qoi exists
+bool exists(const QString &path);
+
+// Decode an image; returns a prefetched copy if one is waiting in the cache.
+QImage loadImage(const QString &path, const QSize &maxSize = QSize());
+// Same, but for the fallback chains: true if something was loaded.
+bool loadImage(QImage &img, const QString &path, const QSize &maxSize = QSize());
+// QPixmap must be created on the GUI thread, so this only wraps loadImage().
+QPixmap loadPixmap(const QString &path, const QSize &maxSize = QSize());
+
+// Crop img to the bounding box of its non-transparent pixels plus a 1px
+// transparent margin, so smooth scaling samples the same edge as before.
+// origin receives the crop's top-left in img. Opaque images come back as is.
+QImage trimmed(const QImage &img, QPoint *origin);
+
+// loadImage() + trimmed(), cached together on disk (see DiskCache)
+QImage loadTrimmed(const QString &path, QPoint *origin);
+
+// Decode the given files in parallel into the cache. Blocks until done, so
+// call it from a worker (see Startup).
+void prefetch(const QList<Request> &requests);
+bool isPrefetched(const QString &path, const QSize &maxSize = QSize());
+void clearPrefetched();
+
+}
+
+#endif // ASSETS_H
@@ -0,0 +1,53 @@
+#include <QCoreApplication>
+#include <QResource>
+#include <QFile>
+#include <QHash>
+#include <QDebug>
+
+#include "bundles.h"
+
+namespace {
+
+QHash<QString, QString> files; // mounted name -> rcc file
+
+QString locate(const QString &name) {
+    const QString dir = QCoreApplication::applicationDirPath();
+    for (const QString &candidate : { dir + "/bundles/" + name + ".rcc",
+                                      dir + "/../Resources/bundles/" + name + ".rcc" }) // macOS app bundle
+        if (QFile::exists(candidate)) return candidate;
+    return QString();
+}
+
+}
+
+namespace Bundles {
+
+bool mount(const QString &name) {
+#ifdef EXTERNAL_ASSETS
+    if (files.contains(name)) return true;
+    const QString file = locate(name);
+    if (file.isEmpty() || !QResource::registerResource(file)) {
+        qWarning() << "bundles: couldn't mount" << name;
+        return false;
+    }
+    files.insert(name, file);
+    qDebug() << "bundles: mounted" << file;
+#else
+    Q_UNUSED(name);
+#endif
+    return true;
+}
+
+bool mount(const QStringList &names) {
+    bool ok = true;
+    for (const QString &name : names) ok &= mount(name);
+    return ok;
+}
+
+void unmountAll() {
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+        if (!QResource::unregisterResource(it.value())) qWarning() << "bundles: couldn't unmount" << it.key();
+    files.clear();
+}
+
+}
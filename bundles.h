@@ -0,0 +1,25 @@
+#ifndef BUNDLES_H
+#define BUNDLES_H
+
+#include <QString>
+#include <QStringList>
+
+// ------------------------------
+// External resource bundles. Built with CONFIG+=external_assets, the level
+// and fighter art is not compiled into the executable but shipped as binary
+// rcc files in bundles/ next to it. Each level mounts the bundles it needs
+// (QResource maps the file, so only pages that are drawn get read) and
+// Game::clear unmounts them again. Paths stay ":/assets/...", so nothing else
+// changes. Without EXTERNAL_ASSETS everything is compiled in and these are
+// no-ops.
+// ------------------------------
+namespace Bundles {
+
+// Mount bundles/<name>.rcc; true if it is available (or compiled in).
+bool mount(const QString &name);
+bool mount(const QStringList &names);
+void unmountAll();
+
+}
+
+#endif // BUNDLES_H
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+
+#include "curvebatch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CURVEBATCH_SSE2
+#endif
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+constexpr float kTwoPi = 6.28318530717959f;
+constexpr float kInvTwoPi = 0.159154943091895f;
+
+// Odd polynomial for sin on [-pi/2, pi/2] (Taylor through x^9, max error
+// about 4e-6 at the ends)
+constexpr float kS3 = -1.6666667e-1f, kS5 = 8.3333333e-3f, kS7 = -1.9841270e-4f, kS9 = 2.7557319e-6f;
+
+}
+
+// Reduce to [-pi, pi], fold onto [-pi/2, pi/2] keeping the sign
+// (sin(x) = sin(pi - x)), then the polynomial. No branches, so the SSE2 path
+// below is the same steps four lanes wide.
+float CurveBatch::sin(float x) {
+    x -= kTwoPi * std::nearbyint(x * kInvTwoPi);
+    const float a = std::min(std::fabs(x), kPi - std::fabs(x));
+    x = std::copysign(a, x);
+    const float x2 = x * x;
+    return x * (1.0f + x2 * (kS3 + x2 * (kS5 + x2 * (kS7 + x2 * kS9))));
+}
+
+#ifdef CURVEBATCH_SSE2
+static inline __m128 sin4(__m128 x) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    // cvtps rounds to nearest in the default MXCSR mode
+    const __m128 k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kInvTwoPi))));
+    x = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(kTwoPi)));
+    const __m128 sign = _mm_and_ps(x, signMask);
+    const __m128 ax = _mm_andnot_ps(signMask, x);
+    x = _mm_or_ps(_mm_min_ps(ax, _mm_sub_ps(_mm_set1_ps(kPi), ax)), sign);
+    const __m128 x2 = _mm_mul_ps(x, x);
+    __m128 p = _mm_add_ps(_mm_set1_ps(kS7), _mm_mul_ps(x2, _mm_set1_ps(kS9)));
+    p = _mm_add_ps(_mm_set1_ps(kS5), _mm_mul_ps(x2, p));
+    p = _mm_add_ps(_mm_set1_ps(kS3), _mm_mul_ps(x2, p));
+    p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, p));
+    return _mm_mul_ps(x, p);
+}
+#endif
+
+// ------------------------------
+// Rigs
+// ------------------------------
+int CurveBatch::addRig(const Anim::ClipDef *clip) {
+    m_dirty = true;
+    for (int i = 0; i < m_rigs.size(); ++i) {
+        if (!m_rigs[i].clip) { m_rigs[i] = Rig(); m_rigs[i].clip = clip; return i; }
+    }
+    Rig r; r.clip = clip;
+    m_rigs.push_back(r);
+    return m_rigs.size() - 1;
+}
+
+void CurveBatch::removeRig(int rig) {
+    m_rigs[rig].clip = nullptr;
+    m_dirty = true;
+}
+
+void CurveBatch::setClip(int rig, const Anim::ClipDef *clip) {
+    if (m_rigs[rig].clip == clip) return;
+    m_rigs[rig].clip = clip;
+    m_dirty = true;
+}
+
+void CurveBatch::clear() {
+    m_rigs.clear();
+    m_dirty = true;
+}
+
+// Lay the channels of all rigs out by curve type. A rig's sines (and
+// linears) are contiguous, so its time is a fill over a range.
+void CurveBatch::pack() {
+    m_sineAmp.clear(); m_sineOmega.clear(); m_sinePhase.clear(); m_sineBias.clear();
+    m_linStart.clear(); m_linRate.clear();
+    QVector<float> consts;
+
+    struct Pending { int group; int index; };   // 0 sine, 1 linear, 2 const
+    QVector<Pending> pending;
+
+    for (Rig &r : m_rigs) {
+        r.slots = pending.size();
+        r.sineBegin = r.sineEnd = m_sineAmp.size();
+        r.linearBegin = r.linearEnd = m_linStart.size();
+        if (!r.clip) continue;
+        const double d = r.clip->durationSec;
+        for (int i = 0; i < r.clip->trackCount; ++i) {
+            const Anim::TrackDef &tr = r.clip->tracks[i];
+            for (const Curve *c : { &tr.x, &tr.y, &tr.rot }) {
+                switch (c->type) {
+                case Curve::Sine:
+                    pending.push_back({ 0, int(m_sineAmp.size()) });
+                    m_sineAmp << float(c->amp);
+                    m_sineOmega << float(d > 0.0 ? 2.0 * M_PI / d : 0.0);
+                    m_sinePhase << float(c->phaseRad);
+                    m_sineBias << float(c->bias);
+                    break;
+                case Curve::Linear:
+                    pending.push_back({ 1, int(m_linStart.size()) });
+                    // duration <= 0 evaluates to end, see Curve::eval
+                    m_linStart << float(d > 0.0 ? c->start : c->end);
+                    m_linRate << float(d > 0.0 ? (c->end - c->start) / d : 0.0);
+                    break;
+                case Curve::Const:
+                    pending.push_back({ 2, int(consts.size()) });
+                    consts << float(c->value);
+                    break;
+                }
+            }
+        }
+        r.sineEnd = m_sineAmp.size();
+        r.linearEnd = m_linStart.size();
+    }
+
+    const int nSine = m_sineAmp.size(), nLin = m_linStart.size();
+    m_sineT.resize(nSine);
+    m_linT.resize(nLin);
+    m_values.resize(nSine + nLin + consts.size());
+    std::copy(consts.cbegin(), consts.cend(), m_values.begin() + nSine + nLin);
+
+    const int base[3] = { 0, nSine, nSine + nLin };
+    m_slots.resize(pending.size());
+    for (int i = 0; i < pending.size(); ++i) m_slots[i] = base[pending[i].group] + pending[i].index;
+    m_dirty = false;
+}
+
+// ------------------------------
+// Evaluation
+// ------------------------------
+void CurveBatch::evaluate() {
+    if (m_dirty) pack();
+
+    for (const Rig &r : m_rigs) {
+        std::fill(m_sineT.begin() + r.sineBegin, m_sineT.begin() + r.sineEnd, r.t);
+        std::fill(m_linT.begin() + r.linearBegin, m_linT.begin() + r.linearEnd, r.t);
+    }
+
+    const int nSine = m_sineAmp.size();
+    const float *amp = m_sineAmp.constData(), *omega = m_sineOmega.constData(), *phase = m_sinePhase.constData();
+    const float *bias = m_sineBias.constData(), *st = m_sineT.constData();
+    float *out = m_values.data();
+    int i = 0;
+#ifdef CURVEBATCH_SSE2
+    for (; i + 4 <= nSine; i += 4) {
+        const __m128 arg = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(omega + i), _mm_loadu_ps(st + i)), _mm_loadu_ps(phase + i));
+        const __m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(amp + i), sin4(arg)), _mm_loadu_ps(bias + i));
+        _mm_storeu_ps(out + i, v);
+    }
+#endif
+    for (; i < nSine; ++i) out[i] = amp[i] * sin(omega[i] * st[i] + phase[i]) + bias[i];
+
+    const int nLin = m_linStart.size();
+    const float *start = m_linStart.constData(), *rate = m_linRate.constData(), *lt = m_linT.constData();
+    out += nSine;
+    // Plain multiply-add; compilers vectorize this on their own
+    for (int j = 0; j < nLin; ++j) out[j] = start[j] + rate[j] * lt[j];
+}
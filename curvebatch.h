@@ -0,0 +1,77 @@
+#ifndef CURVEBATCH_H
+#define CURVEBATCH_H
+
+#include <QVector>
+
+#include "anim.h"
+
+// ------------------------------
+// Evaluates the x/y/rotation curves of many rigs at once, for crowds of
+// PellsBawl-style walkers where per-track Curve::eval calls add up.
+//
+// Every active rig's channels are kept structure-of-arrays, grouped by curve
+// type: sines as amp/omega/phase/bias columns, linears as start/rate, consts
+// written once. evaluate() runs one pass per group over contiguous floats,
+// four lanes at a time with SSE2 (scalar fallback elsewhere) and a polynomial
+// sine good to a few 1e-6 of the amplitude. Results are floats; a pixel
+// offset doesn't need more.
+//
+//   CurveBatch batch;
+//   int rig = batch.addRig(&PellsBawlAnim::kClips[PellsBawlAnim::Walk]);
+//   batch.setTime(rig, t);
+//   batch.evaluate();
+//   float y = batch.value(rig, track, CurveBatch::Y);
+//
+// Switching clips or adding/removing rigs re-packs the columns on the next
+// evaluate(); setTime() alone does not.
+//
+// Not part of the game build yet: a single PellsBawl is cheaper on the scalar
+// path. tools/curvebench builds it until the crowd scenes exist.
+// ------------------------------
+class CurveBatch {
+public:
+    enum Channel { X, Y, Rot, ChannelCount };
+
+    int addRig(const Anim::ClipDef *clip);   // slots of removed rigs are reused
+    void removeRig(int rig);
+    void setClip(int rig, const Anim::ClipDef *clip);
+    void setTime(int rig, double t) { m_rigs[rig].t = float(t); }
+    void clear();
+
+    void evaluate();
+
+    // Track index as in the clip's table (draw order)
+    float value(int rig, int track, Channel c) const {
+        return m_values[m_slots[m_rigs[rig].slots + track * ChannelCount + c]];
+    }
+    int rigCount() const { return m_rigs.size(); }
+    int channelCount() const { return m_slots.size(); } // as of the last evaluate()
+
+    // Polynomial sine used by evaluate(), exposed for the benchmark
+    static float sin(float x);
+
+private:
+    struct Rig {
+        const Anim::ClipDef *clip = nullptr;
+        float t = 0.0f;
+        int slots = 0;                 // first entry in m_slots
+        int sineBegin = 0, sineEnd = 0;
+        int linearBegin = 0, linearEnd = 0;
+    };
+
+    void pack();
+
+    QVector<Rig> m_rigs;
+    bool m_dirty = false;
+
+    // Sines: value = amp * sin(omega * t + phase) + bias
+    QVector<float> m_sineAmp, m_sineOmega, m_sinePhase, m_sineBias, m_sineT;
+    // Linears: value = start + rate * t
+    QVector<float> m_linStart, m_linRate, m_linT;
+
+    // Outputs: [sines | linears | consts], m_slots maps rig channels into it
+    QVector<float> m_values;
+    QVector<int> m_slots;
+};
+
+#endif // CURVEBATCH_H
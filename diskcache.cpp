@@ -0,0 +1,120 @@
+#include <QFile>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <cstring>
+
+#include "diskcache.h"
+
+namespace {
+
+const quint32 kMagic = 0x43534250; // "PBSC"
+const quint32 kVersion = 1;
+const qint64 kDataOffset = 64;     // keeps scanlines 64-byte aligned in the map
+
+struct Header {
+    quint32 magic;
+    quint32 version;
+    qint32 width, height, bytesPerLine;
+    qint32 format;
+    qint32 originX, originY;
+};
+static_assert(sizeof(Header) <= kDataOffset, "header must fit before the pixels");
+
+QString cacheDir() {
+    static const QString dir = [] {
+        const QString d = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/sprites";
+        QDir().mkpath(d);
+        return d;
+    }();
+    return dir;
+}
+
+QString entryPath(const QByteArray &key) {
+    return cacheDir() + '/' + QString::fromLatin1(key) + ".px";
+}
+
+// The formats store() writes; anything else in a header is a broken entry
+bool cachedFormat(qint32 format) {
+    return format == QImage::Format_ARGB32_Premultiplied || format == QImage::Format_ARGB32
+        || format == QImage::Format_RGB32;
+}
+
+// Owns the mapping for as long as the QImage (and its copies) live
+void releaseMapping(void *info) {
+    delete static_cast<QFile *>(info);
+}
+
+}
+
+namespace DiskCache {
+
+QByteArray key(const QString &path, const QByteArray &params) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QByteArray();
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    h.addData(&f);
+    h.addData(params);
+    return h.result().toHex();
+}
+
+bool load(const QByteArray &key, QImage &img, QPoint *origin) {
+    if (key.isEmpty()) return false;
+    auto *f = new QFile(entryPath(key));
+    if (!f->open(QIODevice::ReadOnly) || f->size() < kDataOffset) { delete f; return false; }
+
+    const uchar *map = f->map(0, f->size());
+    if (!map) { delete f; return false; }
+    Header hd;
+    std::memcpy(&hd, map, sizeof(hd));
+    if (hd.magic != kMagic || hd.version != kVersion) { delete f; return false; }
+
+    // A bad entry is dropped, so the next run decodes and stores it afresh
+    auto drop = [&] {
+        f->unmap(const_cast<uchar *>(map));
+        f->close();
+        f->remove();
+        delete f;
+        return false;
+    };
+    if (!cachedFormat(hd.format) || hd.width <= 0 || hd.height <= 0) return drop();
+    const QImage::Format format = QImage::Format(hd.format);
+    const qint64 bytes = qint64(hd.bytesPerLine) * hd.height;
+    const qint64 row = (qint64(hd.width) * QImage::toPixelFormat(format).bitsPerPixel() + 7) / 8;
+    if (hd.bytesPerLine < row || f->size() < kDataOffset + bytes) return drop();
+
+    QImage mapped(map + kDataOffset, hd.width, hd.height, hd.bytesPerLine, format, releaseMapping, f);
+    // A null image never calls releaseMapping, so f is still ours
+    if (mapped.isNull()) return drop();
+    img = mapped;
+    if (origin) *origin = QPoint(hd.originX, hd.originY);
+    return true;
+}
+
+void store(const QByteArray &key, const QImage &img, const QPoint &origin) {
+    if (key.isEmpty() || img.isNull() || !cachedFormat(img.format())) return;
+
+    Header hd;
+    hd.magic = kMagic;
+    hd.version = kVersion;
+    hd.width = img.width();
+    hd.height = img.height();
+    hd.bytesPerLine = int(img.bytesPerLine());
+    hd.format = int(img.format());
+    hd.originX = origin.x();
+    hd.originY = origin.y();
+
+    QByteArray head(kDataOffset, '\0');
+    std::memcpy(head.data(), &hd, sizeof(hd));
+
+    // Written aside and renamed, so a reader never maps half an entry
+    QSaveFile f(entryPath(key));
+    if (!f.open(QIODevice::WriteOnly)) return;
+    f.write(head);
+    f.write(reinterpret_cast<const char *>(img.constBits()), img.sizeInBytes());
+    if (!f.commit()) qWarning() << "sprite cache: couldn't write" << f.fileName();
+}
+
+}
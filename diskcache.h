@@ -0,0 +1,30 @@
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include <QImage>
+#include <QString>
+#include <QByteArray>
+#include <QPoint>
+
+// ------------------------------
+// Persistent cache of processed sprite pixels (decoded, converted to the
+// premultiplied format, scaled and trimmed). Entries are keyed by a hash of
+// the source file contents plus the processing parameters, and stored raw:
+// a small header followed by the scanlines, so a hit is a file map and no
+// decode. The returned QImage points straight into the mapping.
+//
+// Lives under QStandardPaths::CacheLocation/sprites. Any stale or broken
+// entry is just a miss; bump kVersion when the processing itself changes.
+// ------------------------------
+namespace DiskCache {
+
+// Cache key for a source file and its processing parameters; empty if the
+// source can't be read.
+QByteArray key(const QString &path, const QByteArray &params);
+
+bool load(const QByteArray &key, QImage &img, QPoint *origin = nullptr);
+void store(const QByteArray &key, const QImage &img, const QPoint &origin = QPoint());
+
+}
+
+#endif // DISKCACHE_H
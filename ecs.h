@@ -0,0 +1,123 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <tuple>
+
+// ------------------------------
+// Minimal entity-component store. An entity is an index; each component
+// type lives in its own sparse set: a dense, contiguous array of values
+// with a parallel array of owners, plus an entity -> slot table. Systems
+// walk the dense array of one component and look the others up, so the
+// cost is linear in what they touch and no object is reached by pointer.
+//
+//   Ecs::World<Position, Velocity> w;
+//   Ecs::Entity e = w.create();
+//   w.add(e, Position{ pos });
+//   w.each<Position, Velocity>([](Ecs::Entity, Position &t, Velocity &v) { t.pos += v.v; });
+//
+// The component list is fixed at compile time. Removing swaps the last
+// value into the hole, so dense order is not stable and references to
+// components don't survive adds or removes of that type.
+// ------------------------------
+namespace Ecs {
+
+using Entity = quint32;
+const Entity kNoEntity = 0xffffffffu;
+
+template<class T>
+class Storage {
+public:
+    bool has(Entity e) const { return e < Entity(m_slot.size()) && m_slot[e] >= 0; }
+    T &get(Entity e) { return m_data[m_slot[e]]; }
+    const T &get(Entity e) const { return m_data[m_slot[e]]; }
+    T *find(Entity e) { return has(e) ? &m_data[m_slot[e]] : nullptr; }
+
+    T &add(Entity e, const T &value) {
+        if (has(e)) return m_data[m_slot[e]] = value;
+        if (e >= Entity(m_slot.size())) m_slot.resize(int(e) + 1, -1);
+        m_slot[e] = m_data.size();
+        m_owner.push_back(e);
+        m_data.push_back(value);
+        return m_data.last();
+    }
+
+    void remove(Entity e) {
+        if (!has(e)) return;
+        const int i = m_slot[e], last = m_data.size() - 1;
+        if (i != last) {
+            m_data[i] = std::move(m_data[last]);
+            m_owner[i] = m_owner[last];
+            m_slot[m_owner[i]] = i;
+        }
+        m_data.removeLast();
+        m_owner.removeLast();
+        m_slot[e] = -1;
+    }
+
+    void clear() { m_slot.clear(); m_owner.clear(); m_data.clear(); }
+
+    int size() const { return m_data.size(); }
+    Entity owner(int i) const { return m_owner[i]; }
+    T &at(int i) { return m_data[i]; }
+
+private:
+    QVector<int> m_slot;        // by entity, -1 when absent
+    QVector<Entity> m_owner;    // by slot
+    QVector<T> m_data;          // by slot
+};
+
+template<class... Components>
+class World {
+public:
+    Entity create() {
+        if (!m_free.isEmpty()) { const Entity e = m_free.takeLast(); m_alive[e] = true; return e; }
+        m_alive.push_back(true);
+        return Entity(m_alive.size() - 1);
+    }
+
+    void destroy(Entity e) {
+        if (!alive(e)) return;
+        (storage<Components>().remove(e), ...);
+        m_alive[e] = false;
+        m_free.push_back(e);
+    }
+
+    bool alive(Entity e) const { return e < Entity(m_alive.size()) && m_alive[e]; }
+    int count() const { return m_alive.size() - m_free.size(); }
+
+    void clear() {
+        (storage<Components>().clear(), ...);
+        m_alive.clear();
+        m_free.clear();
+    }
+
+    template<class T> Storage<T> &storage() { return std::get<Storage<T>>(m_storages); }
+    template<class T> T &add(Entity e, const T &value = T()) { return storage<T>().add(e, value); }
+    template<class T> void remove(Entity e) { storage<T>().remove(e); }
+    template<class T> bool has(Entity e) { return storage<T>().has(e); }
+    template<class T> T *find(Entity e) { return storage<T>().find(e); }
+    template<class T> T &get(Entity e) { return storage<T>().get(e); }
+
+    // f(entity, First&, Rest&...) for every entity with all of them, in the
+    // dense order of First; put the rarest component first
+    template<class First, class... Rest, class F>
+    void each(F f) {
+        Storage<First> &lead = storage<First>();
+        for (int i = 0; i < lead.size(); ++i) {
+            const Entity e = lead.owner(i);
+            if (!(storage<Rest>().has(e) && ...)) continue;
+            f(e, lead.at(i), storage<Rest>().get(e)...);
+        }
+    }
+
+private:
+    std::tuple<Storage<Components>...> m_storages;
+    QVector<bool> m_alive;
+    QVector<Entity> m_free;
+};
+
+}
+
+#endif // ECS_H
@@ -0,0 +1,209 @@
+#include <QDebug>
+#include <QPainter>
+#include <iterator>
+
+#include "assets.h"
+#include "entities.h"
+#include "fighter.h"
+#include "pellsBawl.h"
+#include "sweep.h"
+
+namespace {
+
+struct EnemyDef {
+    const char *name;
+    const char *sad, *happy;
+    qreal width, height, speed;
+    EnemyType::Behaviour behaviour;
+};
+
+const EnemyDef kEnemies[] = {
+    { "sad",      ":/assets/testlevel/enemy_sad.png", ":/assets/testlevel/enemy_happy.png", 40, 40, 2.0, EnemyType::Walk },
+    { "sad_idle", ":/assets/testlevel/enemy_sad.png", ":/assets/testlevel/enemy_happy.png", 40, 40, 0.0, EnemyType::Stand },
+};
+
+const qreal kGravity = 0.5;      // px per tick^2
+const qreal kMaxFall = 12.0;     // px per tick
+const qreal kFootSkin = 2.0;     // how far feet may be off a surface and still stand on it
+
+// Height of the walkable top of s at x (see triLocal in Game.cpp)
+qreal surfaceY(const Shape &s, qreal x) {
+    const QRectF &r = s.rect;
+    const qreal u = r.width() > 0 ? qBound(0.0, (x - r.left()) / r.width(), 1.0) : 0.0;
+    switch (s.shape) {
+    case Shape::TriLeft: return r.bottom() - u * r.height();
+    case Shape::TriRight: return r.top() + u * r.height();
+    default: return r.top();
+    }
+}
+
+// The shape whose top the feet of body rest on, -1 if none
+int support(const QRectF &body, const QList<Shape> &shapes, const ShapeIndex &index) {
+    const qreal x = body.center().x(), feet = body.bottom();
+    ShapeIndex::Hits hits;
+    index.query(QRectF(x, feet - kFootSkin, 0, 2 * kFootSkin), hits);
+    for (int i : hits) {
+        const Shape &s = shapes[i];
+        if (x < s.rect.left() || x > s.rect.right()) continue;
+        if (qAbs(surfaceY(s, x) - feet) <= kFootSkin) return i;
+    }
+    return -1;
+}
+
+}
+
+// ------------------------------
+// Enemy kinds
+// ------------------------------
+const EnemyType *EnemyTypes::find(const QString &name) {
+    if (m_types.isEmpty()) m_types.resize(int(std::size(kEnemies)));
+    for (int i = 0; i < m_types.size(); ++i) {
+        const EnemyDef &d = kEnemies[i];
+        if (name != QLatin1String(d.name)) continue;
+        EnemyType &t = m_types[i];
+        if (t.name.isEmpty()) {
+            t.name = name;
+            t.frames[0] = Assets::loadPixmap(d.sad);
+            t.frames[1] = Assets::loadPixmap(d.happy);
+            t.size = QSizeF(d.width, d.height);
+            t.speed = d.speed;
+            t.behaviour = d.behaviour;
+        }
+        return &t;
+    }
+    qWarning() << "unknown enemy" << name;
+    return nullptr;
+}
+
+QStringList EnemyTypes::artPaths() {
+    QStringList paths;
+    for (const EnemyDef &d : kEnemies) paths << d.sad << d.happy;
+    paths.removeDuplicates();
+    return paths;
+}
+
+// ------------------------------
+// Archetypes
+// ------------------------------
+namespace Archetypes {
+
+Ecs::Entity enemy(EntityWorld &w, const EnemyType *type, const QPointF &feet, bool facingLeft) {
+    const QSizeF size = type->size;
+    const Ecs::Entity e = w.create();
+    w.add(e, Position{ feet - QPointF(size.width() / 2.0, size.height()) });
+    w.add(e, Velocity());
+    w.add(e, Collider{ QRectF(QPointF(), size), Collider::Enemy });
+    w.add(e, Sprite{ type, 0 });
+    Patrol p;
+    p.speed = type->behaviour == EnemyType::Walk ? type->speed : 0.0;
+    p.movingLeft = facingLeft;
+    w.add(e, p);
+    return e;
+}
+
+Ecs::Entity player(EntityWorld &w, PellsBawl *pb) {
+    const Ecs::Entity e = w.create();
+    const QRectF r = pb->playerRectangle();
+    w.add(e, Position{ r.topLeft() });
+    w.add(e, Collider{ QRectF(QPointF(), r.size()), Collider::Player });
+    w.add(e, Actor{ pb, nullptr, nullptr });
+    return e;
+}
+
+Ecs::Entity fighter(EntityWorld &w, Fighter *f, FighterAI *ai) {
+    const Ecs::Entity e = w.create();
+    const QSizeF body = f->bodySize();
+    w.add(e, Position{ f->pos() });
+    w.add(e, Collider{ QRectF(-body.width() / 2.0, -body.height(), body.width(), body.height()), Collider::Opponent });
+    w.add(e, Actor{ nullptr, f, ai });
+    return e;
+}
+
+}
+
+// ------------------------------
+// Systems
+// ------------------------------
+namespace Systems {
+
+void syncActors(EntityWorld &w) {
+    w.each<Actor, Position, Collider>([](Ecs::Entity, Actor &a, Position &t, Collider &c) {
+        if (a.pellsBawl) {
+            const QRectF r = a.pellsBawl->playerRectangle();
+            t.pos = r.topLeft();
+            c.box.setSize(r.size());
+        } else if (a.fighter) {
+            t.pos = a.fighter->pos();
+        }
+    });
+}
+
+// Bound enemies walk their platform's top and turn at its ends, no lookup
+// involved. Unbound ones look for support under their feet, then fall until
+// they land on something; those falling out of bounds are removed.
+void patrol(EntityWorld &w, const QList<Shape> &shapes, const ShapeIndex &index, const QRectF &bounds) {
+    const quint32 generation = index.generation();
+    QVarLengthArray<Ecs::Entity, 8> lost;
+    w.each<Patrol, Position, Collider, Velocity>([&](Ecs::Entity e, Patrol &p, Position &t, Collider &c, Velocity &v) {
+        const QRectF body = c.at(t);
+        if (p.platform >= 0 && p.boundFor != generation) p.platform = -1;
+        if (p.platform < 0 && (p.platform = support(body, shapes, index)) >= 0) {
+            p.boundFor = generation;
+            p.fall = 0.0;
+        }
+
+        if (p.platform < 0) {
+            p.fall = qMin(p.fall + kGravity, kMaxFall);
+            const QPointF delta(0, p.fall);
+            const Sweep::Hit hit = Sweep::first(body, delta, shapes, index);
+            v.v = delta * hit.toi;
+            if (hit.isHit() && hit.normal.y() < 0) {
+                p.platform = hit.shape;
+                p.boundFor = generation;
+                p.fall = 0.0;
+            }
+            if (body.top() > bounds.bottom()) lost.append(e);
+            return;
+        }
+
+        const QRectF &platform = shapes[p.platform].rect;
+        qreal dx = p.movingLeft ? -p.speed : p.speed;
+        if (p.movingLeft && body.left() + dx <= platform.left()) { dx = qMin(0.0, platform.left() - body.left()); p.movingLeft = false; }
+        else if (!p.movingLeft && body.right() + dx >= platform.right()) { dx = qMax(0.0, platform.right() - body.right()); p.movingLeft = true; }
+        const qreal x = body.center().x() + dx;
+        v.v = QPointF(dx, surfaceY(shapes[p.platform], x) - body.bottom());
+    });
+    for (Ecs::Entity e : lost) w.destroy(e);
+}
+
+void integrate(EntityWorld &w) {
+    w.each<Velocity, Position>([](Ecs::Entity, Velocity &v, Position &t) { t.pos += v.v; });
+}
+
+// The player touching an enemy cheers it up
+void contacts(EntityWorld &w) {
+    QVarLengthArray<QRectF, 2> players;
+    w.each<Actor, Position, Collider>([&](Ecs::Entity, Actor &, Position &t, Collider &c) {
+        if (c.layer == Collider::Player) players.append(c.at(t));
+    });
+    if (players.isEmpty()) return;
+    w.each<Patrol, Position, Collider, Sprite>([&](Ecs::Entity, Patrol &p, Position &t, Collider &c, Sprite &s) {
+        if (p.defeated) return;
+        const QRectF body = c.at(t);
+        for (const QRectF &r : players) {
+            if (!r.intersects(body)) continue;
+            p.defeated = true;
+            s.frame = 1;
+            break;
+        }
+    });
+}
+
+void paintSprites(EntityWorld &w, QPainter &p) {
+    w.each<Sprite, Position, Collider>([&](Ecs::Entity, Sprite &s, Position &t, Collider &c) {
+        const QPixmap &pm = s.type->frames[s.frame];
+        p.drawPixmap(c.at(t), pm, QRectF(pm.rect()));
+    });
+}
+
+}
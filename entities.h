@@ -0,0 +1,110 @@
+#ifndef ENTITIES_H
+#define ENTITIES_H
+
+#include <QList>
+#include <QPixmap>
+#include <QRectF>
+#include <QStringList>
+#include <QVector>
+
+#include "ecs.h"
+#include "platform.h"
+#include "shapeindex.h"
+
+class QPainter;
+class PellsBawl;
+class Fighter;
+class FighterAI;
+
+// ------------------------------
+// Enemy kinds: art, size, speed and behaviour, loaded once per kind and
+// shared by every enemy of it. Levels name the kind in their spawns.
+// ------------------------------
+struct EnemyType {
+    enum Behaviour : quint8 { Stand, Walk };
+    QString name;
+    QPixmap frames[2];           // sad, happy
+    QSizeF size;
+    qreal speed = 0.0;           // px per tick
+    Behaviour behaviour = Stand;
+};
+
+class EnemyTypes {
+public:
+    // The kind called name, its art loaded on first use; null if unknown.
+    // Pointers stay valid for the registry's life.
+    const EnemyType *find(const QString &name);
+    // Every kind's art, for prefetching
+    static QStringList artPaths();
+
+private:
+    QVector<EnemyType> m_types;  // by built-in kind, sized once
+};
+
+// ------------------------------
+// Components of the level's entities, and the archetypes built from them:
+//   enemy    Position Velocity Collider Sprite Patrol
+//   player   Position Collider Actor        (PellsBawl)
+//   fighter  Position Collider Actor        (Fighter + FighterAI)
+// PellsBawl and Fighter keep their own physics and animation; their Actor
+// component points at them and syncActors mirrors where they are, so the
+// systems below treat every body alike.
+// ------------------------------
+struct Position {
+    QPointF pos;                 // top-left for sprites, the actor's anchor otherwise
+};
+
+struct Velocity {
+    QPointF v;                   // px per tick
+};
+
+struct Collider {
+    enum Layer : quint8 { Player, Enemy, Opponent };
+    QRectF box;                  // relative to Position::pos
+    Layer layer = Enemy;
+
+    QRectF at(const Position &t) const { return box.translated(t.pos); }
+};
+
+struct Sprite {
+    const EnemyType *type = nullptr;
+    quint8 frame = 0;            // into type->frames
+};
+
+// Walks back and forth on the platform it is bound to. The binding is found
+// once, at spawn or on landing, and only looked for again when the level's
+// shapes change; unbound enemies fall.
+struct Patrol {
+    qreal speed = 0.0;           // px per tick, 0 stands
+    bool movingLeft = true;
+    bool defeated = false;       // touched by the player, keeps walking
+    int platform = -1;           // shape walked on, -1 while falling
+    quint32 boundFor = 0;        // ShapeIndex::generation() of platform
+    qreal fall = 0.0;            // px per tick, down
+};
+
+struct Actor {
+    PellsBawl *pellsBawl = nullptr;
+    Fighter *fighter = nullptr;
+    FighterAI *ai = nullptr;
+};
+
+using EntityWorld = Ecs::World<Position, Velocity, Collider, Sprite, Patrol, Actor>;
+
+namespace Archetypes {
+// Standing with its feet (bottom middle) at feet
+Ecs::Entity enemy(EntityWorld &w, const EnemyType *type, const QPointF &feet, bool facingLeft);
+Ecs::Entity player(EntityWorld &w, PellsBawl *pb);
+Ecs::Entity fighter(EntityWorld &w, Fighter *f, FighterAI *ai);
+}
+
+// Run once per tick in this order, after the actors moved themselves
+namespace Systems {
+void syncActors(EntityWorld &w);
+void patrol(EntityWorld &w, const QList<Shape> &shapes, const ShapeIndex &index, const QRectF &bounds);
+void integrate(EntityWorld &w);
+void contacts(EntityWorld &w);
+void paintSprites(EntityWorld &w, QPainter &p);
+}
+
+#endif // ENTITIES_H
@@ -12,6 +12,8 @@
 #include <QtGui>
 
 #include "fighter.h"
+#include "assets.h"
+#include "jsonreader.h"
 
 
 // -----------------------------------------------------------------------------
@@ -19,75 +21,145 @@
 // -----------------------------------------------------------------------------
 
 // ----- Loading -----
+// One pass with JsonReader; frame images are loaded after the parse, because
+// "imagesBasePath" may come after "actions" in the file.
+namespace {
+
+void readPhysics(JsonReader& r, FighterConfig& cfg){
+    if(!r.beginObject()) return;
+    while(r.nextKey()){
+        if(r.key("gravity")) cfg.gravity = r.readDouble(cfg.gravity);
+        else if(r.key("groundY")) cfg.groundY = r.readDouble(cfg.groundY);
+        else if(r.key("walkSpeed")) cfg.walkSpeed = r.readDouble(cfg.walkSpeed);
+        else if(r.key("crouchSpeed")) cfg.crouchSpeed = r.readDouble(cfg.crouchSpeed);
+        else if(r.key("jumpSpeed")) cfg.jumpSpeed = r.readDouble(cfg.jumpSpeed);
+        else if(r.key("airControl")) cfg.airControl = r.readDouble(cfg.airControl);
+        else if(r.key("jumpSpinDegPerSec")) cfg.jumpSpinDegPerSec = r.readDouble(cfg.jumpSpinDegPerSec);
+        else if(r.key("bodySize")){
+            double v[2] = {0, 0}; int n = 0;
+            if(r.beginArray()) for(; r.nextElement(); ++n){ if(n < 2) v[n] = r.readDouble(); else r.skip(); }
+            if(n >= 2) cfg.bodySize = QSizeF(v[0], v[1]);
+        }
+        else r.skip();
+    }
+}
+
+AnimFrame readFrame(JsonReader& r, QString* img){
+    AnimFrame fr;
+    if(!r.beginObject()) return fr;
+    while(r.nextKey()){
+        if(r.key("img")) *img = r.readString();
+        else if(r.key("dur")) fr.ticks = qMax(1, r.readInt(100) * Fighter::kTicksPerSecond / 1000);
+        else if(r.key("dx")) fr.offset.setX(r.readDouble());
+        else if(r.key("dy")) fr.offset.setY(r.readDouble());
+        else if(r.key("imgOffset")){
+            double v[2] = {0, 0}; int n = 0;
+            if(r.beginArray()) for(; r.nextElement(); ++n){ if(n < 2) v[n] = r.readDouble(); else r.skip(); }
+            if(n >= 2) fr.imageOffset = { v[0], v[1] };
+        }
+        else if(r.key("imgScale")) fr.scale = r.readDouble(1.0);
+        else if(r.key("rot")) fr.rotation = r.readDouble(0.0);
+        else r.skip();
+    }
+    return fr;
+}
+}
+
 bool Fighter::loadFromJson(const QString& filePath, QString* err){
     QFile f(filePath);
     if(!f.open(QIODevice::ReadOnly)){
         if(err) *err = QString("Failed to open %1").arg(filePath);
         return false;
     }
-    QJsonParseError pe; auto doc = QJsonDocument::fromJson(f.readAll(), &pe);
-    if(pe.error != QJsonParseError::NoError){ if(err) *err = pe.errorString(); return false; }
-    if(!doc.isObject()) { if(err) *err = "Root must be object"; return false; }
-    const QJsonObject root = doc.object();
-    m_cfg.basePath = root.value("imagesBasePath").toString(m_cfg.basePath);
-    m_cfg.spriteScale = root.value("spriteScale").toDouble(m_cfg.spriteScale);
-    if(root.contains("physics")){
-        auto ph = root.value("physics").toObject();
-        m_cfg.gravity = ph.value("gravity").toDouble(m_cfg.gravity);
-        m_cfg.groundY = ph.value("groundY").toDouble(m_cfg.groundY);
-        m_cfg.walkSpeed = ph.value("walkSpeed").toDouble(m_cfg.walkSpeed);
-        m_cfg.crouchSpeed = ph.value("crouchSpeed").toDouble(m_cfg.crouchSpeed);
-        m_cfg.jumpSpeed = ph.value("jumpSpeed").toDouble(m_cfg.jumpSpeed);
-        m_cfg.airControl = ph.value("airControl").toDouble(m_cfg.airControl);
-        m_cfg.jumpSpinDegPerSec = ph.value("jumpSpinDegPerSec").toDouble(m_cfg.jumpSpinDegPerSec);
-        if(ph.contains("bodySize")){
-            auto arr = ph.value("bodySize").toArray();
-            if(arr.size()>=2) m_cfg.bodySize = QSizeF(arr.at(0).toDouble(), arr.at(1).toDouble());
-        }
-    }
-    // Animations
+    const QByteArray data = f.readAll();
+    JsonReader r(data);
+    if(!r.beginObject()) { if(err) *err = "Root must be object"; return false; }
+
     m_anims.clear();
-    if(root.contains("actions")){
-        const auto anims = root.value("actions").toObject();
-        for(auto it = anims.begin(); it != anims.end(); ++it){
-            auto io = it->toObject();
-            if(io.contains("frames")){
-                const auto frames = io.value("frames").toArray();
-
-                Animation A; A.key = it.key(); A.loop = true;
-                // const auto frames = it.value().toArray();
-
-                A.frames.reserve(frames.size());
-                for(const auto& v : frames){
-                    const auto fo = v.toObject();
-                    AnimFrame fr;
-                    const QString imgPath = m_cfg.basePath + fo.value("img").toString();
-                    QPixmap px(imgPath);
-                    if(px.isNull()){
-                        // create placeholder if missing
-                        px = QPixmap(32,32); px.fill(Qt::magenta);
-                    }
-                    fr.pix = px;
-                    fr.durationMs = fo.value("dur").toInt(100);
-                    if(fo.contains("dx")) fr.offset.setX(fo.value("dx").toDouble());
-                    if(fo.contains("dy")) fr.offset.setX(fo.value("dy").toDouble());
-                    if(fo.contains("imgOffset")){
-                        auto a = fo.value("imgOffset").toArray(); if(a.size()>=2) fr.imageOffset = { a.at(0).toDouble(), a.at(1).toDouble() };
+    QHash<QString, int> byKey; // a repeated key replaces the earlier one
+    QVector<QStringList> images; // per animation, per frame
+    while(r.nextKey()){
+        if(r.key("imagesBasePath")) m_cfg.basePath = r.readString(m_cfg.basePath);
+        else if(r.key("spriteScale")) m_cfg.spriteScale = r.readDouble(m_cfg.spriteScale);
+        else if(r.key("physics")) readPhysics(r, m_cfg);
+        else if(r.key("actions")){
+            if(r.beginObject()) while(r.nextKey()){
+                Animation A; A.key = r.keyString(); A.loop = true;
+                QStringList imgs;
+                bool hasFrames = false;
+                if(r.beginObject()){
+                    while(r.nextKey()){
+                        if(r.key("frames")){
+                            if(r.beginArray()){
+                                hasFrames = true;
+                                while(r.nextElement()){
+                                    QString img;
+                                    A.frames.push_back(readFrame(r, &img));
+                                    imgs << img;
+                                }
+                            }
+                        }
+                        else r.skip();
                     }
-                    fr.scale = fo.value("imgScale").toDouble(1.0);
-                    fr.rotation = fo.value("rot").toDouble(0.0);
-                    A.frames.push_back(fr);
                 }
-                m_anims.insert(A.key, A);
+                if(!hasFrames) continue;
+                if(byKey.contains(A.key)){
+                    const int i = byKey.value(A.key);
+                    m_anims[i] = A;
+                    images[i] = imgs;
+                }
+                else { byKey.insert(A.key, m_anims.size()); m_anims.push_back(A); images.push_back(imgs); }
             }
         }
+        else r.skip();
+    }
+    if(r.hasError()){ if(err) *err = r.errorString(); m_anims.clear(); return false; }
+
+    for(int a = 0; a < m_anims.size(); ++a) for(int i = 0; i < m_anims[a].frames.size(); ++i){
+        AnimFrame& fr = m_anims[a].frames[i];
+        const QString imgPath = m_cfg.basePath + images[a][i];
+        QPoint crop;
+        QImage img = Assets::loadTrimmed(imgPath, &crop); // frames are mostly padding
+        if(img.isNull()){
+            // create placeholder if missing
+            img = QImage(32,32, QImage::Format_RGB32); img.fill(Qt::magenta);
+        }
+        fr.pix = QPixmap::fromImage(img);
+        // paint() draws at (0,0) after translate(imageOffset) and scale(scale)
+        fr.imageOffset += QPointF(crop) * fr.scale;
     }
-    selectAnim(animKeyFor(Action::Stand)); //, Dir::Right));
+    resolveAnims();
+    restartAnim();
     return true;
 }
 
+// Map every action and facing to a loaded animation once, so nothing is
+// looked up by name while running
+void Fighter::resolveAnims(){
+    QHash<QString, int> byKey;
+    for(int i = 0; i < m_anims.size(); ++i) byKey.insert(m_anims[i].key, i);
+
+    for(int a = 0; a < kActionCount; ++a){
+        const QString key = animKeyFor(Action(a));
+        const int shared = byKey.value(key, -1);
+        const int left = byKey.value(key + "-left", -1);
+        const int right = byKey.value(key + "-right", -1);
+        // shared art faces left and is mirrored for right
+        AnimSlot& L = m_slots[a][int(Dir::Left)];
+        AnimSlot& R = m_slots[a][int(Dir::Right)];
+        if(left >= 0) L = { left, false };
+        else if(shared >= 0) L = { shared, false };
+        else if(right >= 0) L = { right, true };
+        else L = AnimSlot();
+        if(right >= 0) R = { right, false };
+        else if(shared >= 0) R = { shared, true };
+        else if(left >= 0) R = { left, true };
+        else R = AnimSlot();
+    }
+}
+
 // ----- Simulation -----
-void Fighter::update(qreal dt, const QVector<Shape>& platforms, const QRectF& worldBounds){
+void Fighter::update(qreal dt, const QVector<Shape>& platforms, const ShapeIndex& index, const QRectF& worldBounds){
     // Horizontal control
     const qreal speed = (m_action==Action::Crouch ? m_cfg.crouchSpeed : m_cfg.walkSpeed);
     const qreal control = m_onGround? 1.0 : m_cfg.airControl;
@@ -110,8 +182,11 @@ void Fighter::update(qreal dt, const QVector<Shape>& platforms, const QRectF& wo
     qreal nextFeetY = next.y();
     // Consider world ground as a platform at groundY
     landY = m_cfg.groundY;
-    for(const Shape& p : platforms){
-        const QRectF& r = p.rect;
+    // Only platforms the feet sweep over this frame can be landed on
+    ShapeIndex::Hits hits;
+    index.query(QRectF(QPointF(feetX-halfW, qMin(prevFeetY, nextFeetY)), QPointF(feetX+halfW, qMax(prevFeetY, nextFeetY))), hits);
+    for(int i : hits){
+        const QRectF& r = platforms[i].rect;
         // If horizontally over platform and moving down past its top
         if( (feetX+halfW) >= r.left() && (feetX-halfW) <= r.right() ){
             if(prevFeetY <= r.top() && nextFeetY >= r.top()){
@@ -137,11 +212,16 @@ void Fighter::update(qreal dt, const QVector<Shape>& platforms, const QRectF& wo
     if(!m_onGround){ m_spin += m_cfg.jumpSpinDegPerSec * dt; if(m_spin >= 360.0) m_spin = std::fmod(m_spin, 360.0); }
     else { if(m_action==Action::Jump) setAction(Action::Stand); }
 
-    // One-shot action timers
-    if(m_actionTimerMs > 0){ m_actionTimerMs -= int(dt*1000.0); if(m_actionTimerMs <= 0){ endOneShot(); }}
+    // Whole ticks this frame; the remainder carries over so short frames don't drift
+    m_tickCarry += dt * kTicksPerSecond;
+    const int ticks = int(m_tickCarry);
+    m_tickCarry -= ticks;
+
+    // One-shot action timers (ms)
+    if(m_actionTimerMs > 0){ m_actionTimerMs -= ticks * 1000 / kTicksPerSecond; if(m_actionTimerMs <= 0){ endOneShot(); }}
 
     // Advance animation clock
-    advanceAnim(int(dt*1000.0));
+    advanceAnim(ticks);
 }
 
 // ----- Painting -----
@@ -150,14 +230,8 @@ void Fighter::paint(QPainter* p) const {
     const AnimFrame* fr = currentFrame();
     if(!fr){ p->restore(); return; }
 
-    // Apply facing via mirroring if we don't have explicit Left animation
-    bool mirror = m_facing == Dir::Right; //false;
-
-    const QString desired = animKeyFor(m_action); //, m_facing);
-    // if(!m_anims.contains(desired)){
-    //     // Mirror from the other side if available
-    //     mirror = (m_facing==Dir::Left);
-    // }
+    // Apply facing via mirroring if we don't have an animation for this side
+    const bool mirror = m_slots[int(m_action)][int(m_facing)].mirror;
 
     // Compute draw transform: feet origin at m_pos
     // Apply world offset then image offset
@@ -34,6 +34,7 @@ static inline Dir flip(Dir d){ return d==Dir::Left? Dir::Right : Dir::Left; }
 // -----------------------------------------------------------------------------
 // struct Platform { QRectF rect; }; // axis-aligned platform
 #include "platform.h"
+#include "shapeindex.h"
 
 struct FighterConfig {
     // Physics
@@ -61,8 +62,8 @@ struct FighterConfig {
 // Animation data driven by JSON
 // -----------------------------------------------------------------------------
 struct AnimFrame {
-    QPixmap pix;           // loaded image
-    int durationMs = 100;  // frame time
+    QPixmap pix;           // loaded image, trimmed to its alpha bounds (see loadFromJson)
+    int ticks = 100;       // frame time in Fighter ticks (ms), at least 1
     QPointF offset = {0,0};      // world offset from character origin (feet) before draw
     QPointF imageOffset = {0,0}; // additional draw offset in image space
     qreal scale = 1.0;     // per-frame scale multiplier
@@ -70,7 +71,7 @@ struct AnimFrame {
 };
 
 struct Animation {
-    QString key;                 // e.g., "Stand_Right"
+    QString key;                 // e.g., "walk", "walk-right"
     QVector<AnimFrame> frames;
     bool loop = true;
 };
@@ -105,6 +106,11 @@ struct Animation {
 // }
 
 // Keys are optional: if you omit "*_Left", the renderer mirrors "*_Right".
+//
+// As loaded (see Fighter::resolveAnims): "actions" keys are the lowercase
+// names from animKeyFor(). A key serves both facings and its art faces left;
+// "<key>-left" / "<key>-right" override one side, and a lone side is mirrored
+// for the other.
 
 // -----------------------------------------------------------------------------
 // Fighter class
@@ -127,9 +133,17 @@ public:
     // bool isAttacking() const { return m_isAttacking; }
 
     Dir facing() const { return m_facing; }
+    QSizeF bodySize() const { return m_cfg.bodySize; }
 
     void setPos(const QPointF& p){ m_pos = p; }
 
+    // Every frame image, e.g. to get them onto the GPU ahead of time
+    QList<QPixmap> pixmaps() const {
+        QList<QPixmap> out;
+        for (const auto& A : m_anims) for (const auto& fr : A.frames) out << fr.pix;
+        return out;
+    }
+
     // ----- Control API (can be wired from AI commander) -----
     void turn(Dir d){ if(m_canTurn) m_facing = d; }
 
@@ -165,37 +179,40 @@ public:
     void victory(){ triggerOneShot(Action::Victory, 4000, false); }
 
     // ----- Simulation -----
-    void update(qreal dt, const QVector<Shape>& platforms, const QRectF& worldBounds);
+    static constexpr int kTicksPerSecond = 1000; // animation clock; JSON durations are ms
+    void update(qreal dt, const QVector<Shape>& platforms, const ShapeIndex& index, const QRectF& worldBounds);
     // ----- Painting -----
     void paint(QPainter* p) const;
 signals:
-    void animationChanged(const QString& key);
+    void animationChanged(Action action);
 
 private:
     // ----- Action/animation handling -----
-    QString animKeyFor(Action a) const { //, Dir d) const {
-        // auto L = QString(d==Dir::Left?"Left":"Right");
+    static constexpr int kActionCount = int(Action::Victory) + 1;
+
+    // JSON key per action; only used while loading
+    static const char* animKeyFor(Action a) {
         switch(a){
-        case Action::Stand: return QStringLiteral("stand"); // + L;
-        case Action::Walk: return QStringLiteral("walk"); //Walk_") + L;
-        case Action::Crouch: return QStringLiteral("crouch"); //Crouch_") + L;
-        case Action::Jump: return QStringLiteral("jump"); //Jump_") + L;
-        case Action::Kick: return QStringLiteral("kick"); //Kick_") + L;
-        case Action::SlowPunch: return QStringLiteral("punch"); //SlowPunch_") + L;
-        case Action::CrouchPunch: return QStringLiteral("crouch-punch"); //CrouchKick_") + L;
-        case Action::AirKick: return QStringLiteral("air-kick"); //AirKick_") + L;
-        case Action::AirPunch: return QStringLiteral("air-punch"); //AirKick_") + L;
-        case Action::CrouchBackflipKick: return QStringLiteral("back-flip"); //CrouchBackflipKick_") + L;
-        case Action::Victory: return QStringLiteral("victory"); //Victory_") + L;
-        case Action::Special: return QStringLiteral("special"); //Victory_") + L;
+        case Action::Stand: return "stand";
+        case Action::Walk: return "walk";
+        case Action::Crouch: return "crouch";
+        case Action::Jump: return "jump";
+        case Action::Kick: return "kick";
+        case Action::SlowPunch: return "punch";
+        case Action::CrouchPunch: return "crouch-punch";
+        case Action::AirKick: return "air-kick";
+        case Action::AirPunch: return "air-punch";
+        case Action::CrouchBackflipKick: return "back-flip";
+        case Action::Victory: return "victory";
+        case Action::Special: return "special";
         }
-        return QStringLiteral("stand"); //_Right");
+        return "stand";
     }
 
     void setAction(Action a){
         if(m_action == a) return;
         m_action = a;
-        selectAnim(animKeyFor(m_action)); //, m_facing));
+        restartAnim();
     }
 
     void triggerOneShot(Action a, int ms, bool returnToStand=true){
@@ -230,44 +247,33 @@ private:
         if(m_action==Action::Jump || m_action==Action::AirKick) setAction(Action::Stand);
     }
 
-    void selectAnim(const QString& key){
-        qDebug() << key;
-        // // Prefer exact key; if missing and key is *Left*, try Right and mirror on paint.
-        if(!m_anims.contains(key)){
-            // Fallback handled in paint via mirror
-            m_animKey = key; m_animIndex = 0; m_animTimeMs = 0; emit animationChanged(key); return;
-        }
-        m_animKey = key; m_animIndex = 0; m_animTimeMs = 0; emit animationChanged(key);
+    void restartAnim(){
+        m_animIndex = 0; m_animTicks = 0; emit animationChanged(m_action);
+    }
+
+    // Animation for the current action and facing, resolved at load
+    const Animation* currentAnim() const {
+        const AnimSlot& s = m_slots[int(m_action)][int(m_facing)];
+        if(s.anim < 0) return nullptr;
+        const Animation& A = m_anims[s.anim];
+        return A.frames.isEmpty() ? nullptr : &A;
     }
 
     const AnimFrame* currentFrame() const {
-        // If we don't have frames for current key, try mirrored side
-        auto it = m_anims.constFind(m_animKey);
-        if(it == m_anims.constEnd()){
-            // Try opposite side key
-            QString alt = m_animKey;
-            alt.replace("Left","Right").replace("Right","Left");
-            it = m_anims.constFind(alt);
-            if(it == m_anims.constEnd()) return nullptr;
-        }
-        const Animation& A = it.value();
-        if(A.frames.isEmpty()) return nullptr;
-        return &A.frames.at(std::clamp(m_animIndex, 0, (int)A.frames.size()-1));
+        const Animation* A = currentAnim();
+        if(!A) return nullptr;
+        return &A->frames.at(std::clamp(m_animIndex, 0, (int)A->frames.size()-1));
     }
 
-    void advanceAnim(int deltaMs){
-        auto it = m_anims.find(m_animKey);
-        if(it == m_anims.end()){
-            // Advance alt if needed
-            QString alt = m_animKey; alt.replace("Left","Right").replace("Right","Left");
-            it = m_anims.find(alt);
-            if(it == m_anims.end()) return;
-        }
-        Animation& A = it.value();
-        if(A.frames.isEmpty()) return;
-        m_animTimeMs += deltaMs;
-        while(m_animTimeMs >= A.frames[m_animIndex].durationMs){
-            m_animTimeMs -= A.frames[m_animIndex].durationMs;
+    void advanceAnim(int ticks){
+        const Animation* cur = currentAnim();
+        if(!cur) return;
+        const Animation& A = *cur;
+        // a facing change can switch to a side with fewer frames
+        m_animIndex = std::clamp(m_animIndex, 0, (int)A.frames.size()-1);
+        m_animTicks += ticks;
+        while(m_animTicks >= A.frames[m_animIndex].ticks){
+            m_animTicks -= A.frames[m_animIndex].ticks;
             if(m_animIndex+1 < A.frames.size()){
                 ++m_animIndex;
             } else if(A.loop) {
@@ -306,10 +312,13 @@ private:
     bool m_returnToStand = true;
 
     // Animation
-    QHash<QString, Animation> m_anims; // key -> animation
-    QString m_animKey;
+    struct AnimSlot { int anim = -1; bool mirror = false; };
+    void resolveAnims();
+    QVector<Animation> m_anims;                 // as loaded
+    AnimSlot m_slots[kActionCount][2];          // [action][facing] -> m_anims
     int m_animIndex = 0;
-    int m_animTimeMs = 0;
+    int m_animTicks = 0;
+    qreal m_tickCarry = 0.0;                    // sub-tick time left from update()
 
     // Spin accumulator for jump-rotate
     qreal m_spin = 0.0;
@@ -335,7 +344,7 @@ private:
 // commander->onVictory = [&](){ fighter->victory(); };
 //
 // In your tick:
-// fighter->update(dtSeconds, platforms, worldBounds);
+// fighter->update(dtSeconds, platforms, platformIndex, worldBounds);
 //
 // In your renderer (e.g. QGraphicsItem::paint or QWidget::paintEvent):
 // QPainter p(this); fighter->paint(&p);
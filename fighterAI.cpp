@@ -121,6 +121,16 @@ Intent FighterAI::decide(){
 bool FighterAI::willProjectileHitWithin(qreal t, Dir& fromDirOut) const {
     const QPointF P = m_self.pos;
     for(const auto& p : m_opp.activeProjectiles){
+        // Known impact: a cookie landing next to us is a threat, one that hits
+        // the level before it gets to our x is not
+        if(p.impactIn >= 0.0){
+            if(p.impactIn <= t && QLineF(p.impactPos, P).length() <= 24.0 + p.radius){
+                fromDirOut = (p.vel.x() >= 0) ? Dir::Left : Dir::Right;
+                return true;
+            }
+            const qreal reach = p.vel.x() != 0.0 ? (P.x() - p.pos.x()) / p.vel.x() : -1.0;
+            if(reach < 0.0 || p.impactIn < reach) continue;
+        }
         // Simple forward projection assuming linear motion
         QPointF future = p.pos + p.vel * t;
         // Consider horizontal pass near our x and y proximity
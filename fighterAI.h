@@ -46,6 +46,8 @@ struct ProjectileInfo {
     QPointF pos {0,0};
     QPointF vel {0,0};
     qreal radius = 6.0; // for simple collision prediction
+    qreal impactIn = -1.0; // seconds until it hits the level or leaves it, < 0 if not known yet
+    QPointF impactPos {0,0};
 };
 
 struct OpponentSnapshot {
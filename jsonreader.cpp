@@ -0,0 +1,254 @@
+#include <cstring>
+#include <limits>
+
+#include "jsonreader.h"
+
+JsonReader::JsonReader(const QByteArray &data)
+    : JsonReader(data.constData(), data.size()) {}
+
+JsonReader::JsonReader(const char *data, qsizetype size)
+    : m_begin(data), m_p(data), m_end(data + size) {}
+
+void JsonReader::skipSpace() {
+    while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) ++m_p;
+}
+
+bool JsonReader::consume(char c) {
+    skipSpace();
+    if (m_p < m_end && *m_p == c) { ++m_p; return true; }
+    return false;
+}
+
+void JsonReader::fail(const char *what) {
+    if (hasError()) return;
+    m_error = QString("%1 at offset %2").arg(QLatin1String(what)).arg(qint64(m_p - m_begin));
+    m_p = m_end; // everything after this reads as End
+}
+
+JsonReader::Type JsonReader::peek() {
+    skipSpace();
+    if (m_p >= m_end) return End;
+    switch (*m_p) {
+    case '{': return Object;
+    case '[': return Array;
+    case '"': return String;
+    case 't': case 'f': return Bool;
+    case 'n': return Null;
+    case '}': case ']': return End;
+    default: return Number;
+    }
+}
+
+// ------------------------------
+// Containers
+// ------------------------------
+bool JsonReader::beginObject() {
+    if (peek() == Object) { ++m_p; return true; }
+    skip();
+    return false;
+}
+
+bool JsonReader::nextKey() {
+    consume(',');
+    if (consume('}')) return false;
+    skipSpace();
+    if (m_p >= m_end || *m_p != '"') { fail("expected key"); return false; }
+
+    m_keyScratch.clear();
+    const char *b = nullptr, *e = nullptr;
+    if (!parseString(&m_keyScratch, &b, &e)) return false;
+    if (b) { m_keyBegin = b; m_keyEnd = e; }
+    else { m_keyBegin = m_keyScratch.constData(); m_keyEnd = m_keyBegin + m_keyScratch.size(); }
+
+    if (!consume(':')) { fail("expected ':'"); return false; }
+    return true;
+}
+
+bool JsonReader::key(const char *name) const {
+    const size_t n = std::strlen(name);
+    return size_t(m_keyEnd - m_keyBegin) == n && std::memcmp(m_keyBegin, name, n) == 0;
+}
+
+QString JsonReader::keyString() const {
+    return QString::fromUtf8(m_keyBegin, m_keyEnd - m_keyBegin);
+}
+
+bool JsonReader::beginArray() {
+    if (peek() == Array) { ++m_p; return true; }
+    skip();
+    return false;
+}
+
+bool JsonReader::nextElement() {
+    consume(',');
+    if (consume(']')) return false;
+    if (m_p >= m_end || *m_p == '}') { fail("unterminated array"); return false; }
+    return true;
+}
+
+// ------------------------------
+// Scalars
+// ------------------------------
+
+// Without escapes, begin/end point into the input and out is left alone;
+// otherwise the unescaped UTF-8 goes to out and begin stays null.
+bool JsonReader::parseString(QByteArray *out, const char **begin, const char **end) {
+    ++m_p; // opening quote
+    const char *start = m_p;
+    while (m_p < m_end && *m_p != '"' && *m_p != '\\') ++m_p;
+    if (m_p < m_end && *m_p == '"') {
+        *begin = start; *end = m_p;
+        ++m_p;
+        return true;
+    }
+
+    out->append(start, m_p - start);
+    while (m_p < m_end && *m_p != '"') {
+        if (*m_p != '\\') { out->append(*m_p++); continue; }
+        if (++m_p >= m_end) break;
+        const char c = *m_p++;
+        switch (c) {
+        case '"': case '\\': case '/': out->append(c); break;
+        case 'b': out->append('\b'); break;
+        case 'f': out->append('\f'); break;
+        case 'n': out->append('\n'); break;
+        case 'r': out->append('\r'); break;
+        case 't': out->append('\t'); break;
+        case 'u': {
+            auto hex4 = [this](uint *v) {
+                if (m_end - m_p < 4) return false;
+                bool ok = false;
+                *v = QByteArray::fromRawData(m_p, 4).toUInt(&ok, 16);
+                m_p += 4;
+                return ok;
+            };
+            uint cp = 0;
+            if (!hex4(&cp)) { fail("bad \\u escape"); return false; }
+            if (cp >= 0xd800 && cp < 0xdc00 && m_end - m_p >= 6 && m_p[0] == '\\' && m_p[1] == 'u') {
+                m_p += 2;
+                uint lo = 0;
+                if (!hex4(&lo)) { fail("bad \\u escape"); return false; }
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+            }
+            const char32_t ch = char32_t(cp);
+            out->append(QString::fromUcs4(&ch, 1).toUtf8());
+            break;
+        }
+        default: fail("bad escape"); return false;
+        }
+    }
+    if (m_p >= m_end) { fail("unterminated string"); return false; }
+    ++m_p; // closing quote
+    *begin = nullptr;
+    return true;
+}
+
+bool JsonReader::parseNumber(double *out) {
+    const char *start = m_p;
+    bool integral = true;
+    if (m_p < m_end && *m_p == '-') ++m_p;
+    while (m_p < m_end) {
+        const char c = *m_p;
+        if (c >= '0' && c <= '9') { ++m_p; continue; }
+        if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') { integral = false; ++m_p; continue; }
+        break;
+    }
+    if (m_p == start) { fail("unexpected character"); return false; }
+
+    // Most numbers in our files are small integers; skip the generic path for those
+    if (integral && m_p - start < 16) {
+        const char *q = start;
+        const bool neg = *q == '-';
+        if (neg) ++q;
+        qint64 v = 0;
+        for (; q < m_p; ++q) v = v * 10 + (*q - '0');
+        *out = double(neg ? -v : v);
+        return true;
+    }
+    bool ok = false;
+    *out = QByteArray::fromRawData(start, m_p - start).toDouble(&ok); // C locale
+    if (!ok) fail("bad number");
+    return ok;
+}
+
+double JsonReader::readDouble(double def) {
+    if (peek() != Number) { skip(); return def; }
+    double v = def;
+    return parseNumber(&v) ? v : def;
+}
+
+int JsonReader::readInt(int def) {
+    // QJsonValue::toInt: only integral values that fit
+    const double v = readDouble(std::numeric_limits<double>::quiet_NaN());
+    if (!(v >= std::numeric_limits<int>::min() && v <= std::numeric_limits<int>::max()) || v != double(int(v)))
+        return def;
+    return int(v);
+}
+
+bool JsonReader::readBool(bool def) {
+    if (peek() != Bool) { skip(); return def; }
+    if (m_end - m_p >= 4 && std::memcmp(m_p, "true", 4) == 0) { m_p += 4; return true; }
+    if (m_end - m_p >= 5 && std::memcmp(m_p, "false", 5) == 0) { m_p += 5; return false; }
+    fail("bad literal");
+    return def;
+}
+
+QString JsonReader::readString(const QString &def) {
+    if (peek() != String) { skip(); return def; }
+    QByteArray buf;
+    const char *b = nullptr, *e = nullptr;
+    if (!parseString(&buf, &b, &e)) return def;
+    return b ? QString::fromUtf8(b, e - b) : QString::fromUtf8(buf);
+}
+
+void JsonReader::skip() {
+    switch (peek()) {
+    case Object:
+        ++m_p;
+        while (nextKey()) skip();
+        break;
+    case Array:
+        ++m_p;
+        while (nextElement()) skip();
+        break;
+    case String: {
+        QByteArray buf;
+        const char *b, *e;
+        parseString(&buf, &b, &e);
+        break;
+    }
+    case Number: { double v; parseNumber(&v); break; }
+    case Bool: readBool(); break;
+    case Null:
+        if (m_end - m_p >= 4 && std::memcmp(m_p, "null", 4) == 0) m_p += 4;
+        else fail("bad literal");
+        break;
+    case End:
+        break; // nothing to skip; the caller's nextKey/nextElement sees the close
+    }
+}
+
+QPointF JsonReader::readPoint() {
+    QPointF p;
+    if (!beginObject()) return p;
+    while (nextKey()) {
+        if (key("x")) p.setX(readDouble());
+        else if (key("y")) p.setY(readDouble());
+        else skip();
+    }
+    return p;
+}
+
+QRectF JsonReader::readRect() {
+    double x = 0, y = 0, w = 0, h = 0;
+    if (beginObject()) {
+        while (nextKey()) {
+            if (key("x")) x = readDouble();
+            else if (key("y")) y = readDouble();
+            else if (key("w")) w = readDouble();
+            else if (key("h")) h = readDouble();
+            else skip();
+        }
+    }
+    return QRectF(x, y, w, h);
+}
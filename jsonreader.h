@@ -0,0 +1,71 @@
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QPointF>
+#include <QRectF>
+
+// ------------------------------
+// Streaming (pull) JSON reader. Walks the text once and hands values straight
+// to the caller, so the schema readers (levels, fighters, the PellsBawl rig)
+// fill their structures without building a QJsonDocument first.
+//
+//   r.beginObject();
+//   while (r.nextKey()) {
+//       if (r.key("x")) x = r.readDouble();
+//       else r.skip();
+//   }
+//
+// The read* calls behave like QJsonValue::to*: a value of another type is
+// skipped and the default returned. Errors stop the reader; every later call
+// returns defaults and hasError() tells.
+// ------------------------------
+class JsonReader {
+public:
+    enum Type { Null, Bool, Number, String, Array, Object, End };
+
+    // data must outlive the reader; it is not copied
+    explicit JsonReader(const QByteArray &data);
+    JsonReader(const char *data, qsizetype size);
+
+    Type peek();
+
+    bool beginObject();              // false (and value skipped) if not an object
+    bool nextKey();                  // false once the object is closed
+    bool key(const char *name) const;
+    QString keyString() const;
+
+    bool beginArray();               // false (and value skipped) if not an array
+    bool nextElement();              // false once the array is closed
+
+    double readDouble(double def = 0.0);
+    int readInt(int def = 0);
+    bool readBool(bool def = false);
+    QString readString(const QString &def = QString());
+    void skip();
+
+    // Level editor shapes: {"x","y"} and {"x","y","w","h"}
+    QPointF readPoint();
+    QRectF readRect();
+
+    bool hasError() const { return !m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+
+private:
+    void skipSpace();
+    bool consume(char c);
+    void fail(const char *what);
+    bool parseString(QByteArray *out, const char **begin, const char **end);
+    bool parseNumber(double *out);
+
+    const char *m_begin;
+    const char *m_p;
+    const char *m_end;
+    const char *m_keyBegin = nullptr;
+    const char *m_keyEnd = nullptr;
+    QByteArray m_keyScratch;         // keys with escapes
+    QString m_error;
+};
+
+#endif // JSONREADER_H
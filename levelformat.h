@@ -0,0 +1,131 @@
+#ifndef LEVELFORMAT_H
+#define LEVELFORMAT_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QRectF>
+#include <cstring>
+
+// ------------------------------
+// Compiled level (.pbl), written by tools/levelc from the level JSON and
+// read by Game::loadWorld straight out of a file mapping, no parsing.
+//
+// Little endian, every record 8-byte aligned, all references are offsets
+// from the start of the file or indices:
+//   Header
+//   ShapeRec[shapes.count]  AreaRec[areas.count]  EnemyRec[enemies.count]
+//   ImageRec[images.count]  ParallaxRec[parallax.count]
+//   StringRec[strings.count] + UTF-8 bytes (ids, titles, paths, interned)
+//   CellRec[cols * rows] + quint32 shape indices (uniform grid over world)
+// ------------------------------
+namespace LevelFormat {
+
+const quint32 kMagic = 0x564c4250; // "PBLV"
+const quint32 kVersion = 3;
+const quint32 kNoString = 0xffffffffu;
+
+struct Section { quint32 offset, count; };
+struct RectRec { double x, y, w, h; };
+
+struct Header {
+    quint32 magic, version;
+    quint32 fileSize, reserved;
+    RectRec world, window;
+    quint32 basePath;          // string index
+    quint32 pad;
+    Section shapes, areas, enemies, images, parallax, strings;
+    // Grid: shape indices per cell, cells row-major
+    double gridX, gridY, cellSize;
+    quint32 cols, rows;
+    Section cells, cellShapes;
+};
+
+enum ShapeKind : quint8 { Rect, TriLeft, TriRight }; // same order as Shape
+
+struct ShapeRec {
+    RectRec rect;
+    quint32 id;
+    quint8 kind, isWall, pad[2];
+};
+
+struct AreaRec {
+    RectRec rect;
+    quint32 id, title;
+    quint32 script, pad;       // kNoString without one
+};
+
+struct EnemyRec {
+    double x, y;               // feet
+    quint32 type;              // string index, the kind's name
+    quint8 facingLeft, pad[3];
+};
+
+struct ImageRec {
+    double x, y, rotation, scaleX, scaleY, z;
+    quint32 id, path;          // path as written in the level
+};
+
+struct ParallaxRec {
+    double offX, offY, rateX, rateY, scale;
+    qint32 z;
+    quint32 image;             // relative to the level directory
+    quint32 wrap, pad;
+};
+
+struct StringRec { quint32 offset, size; };
+struct CellRec { quint32 first, count; };
+
+static_assert(sizeof(Header) % 8 == 0 && sizeof(ShapeRec) % 8 == 0 && sizeof(AreaRec) % 8 == 0
+              && sizeof(EnemyRec) % 8 == 0 && sizeof(ImageRec) % 8 == 0 && sizeof(ParallaxRec) % 8 == 0, "records must stay 8-byte aligned");
+
+inline QRectF toRect(const RectRec &r) { return QRectF(r.x, r.y, r.w, r.h); }
+inline RectRec fromRect(const QRectF &r) { return RectRec{ r.x(), r.y(), r.width(), r.height() }; }
+
+// Read-only view over a mapped file. valid() checks magic, version, that the
+// data starts 8-byte aligned and that every section lies inside it, aligned;
+// the accessors trust it after that.
+class View {
+public:
+    View(const uchar *data, qint64 size) : m_data(data), m_size(size) {}
+
+    bool valid() const {
+        if (!m_data || quintptr(m_data) % 8 || m_size < qint64(sizeof(Header))) return false;
+        const Header &h = header();
+        return h.magic == kMagic && h.version == kVersion && h.fileSize <= m_size
+            && inside(h.shapes, sizeof(ShapeRec)) && inside(h.areas, sizeof(AreaRec))
+            && inside(h.enemies, sizeof(EnemyRec))
+            && inside(h.images, sizeof(ImageRec)) && inside(h.parallax, sizeof(ParallaxRec))
+            && inside(h.strings, sizeof(StringRec)) && inside(h.cells, sizeof(CellRec))
+            && inside(h.cellShapes, sizeof(quint32)) && quint64(h.cols) * h.rows == h.cells.count;
+    }
+
+    const Header &header() const { return *reinterpret_cast<const Header *>(m_data); }
+
+    const ShapeRec *shapes() const { return at<ShapeRec>(header().shapes); }
+    const AreaRec *areas() const { return at<AreaRec>(header().areas); }
+    const EnemyRec *enemies() const { return at<EnemyRec>(header().enemies); }
+    const ImageRec *images() const { return at<ImageRec>(header().images); }
+    const ParallaxRec *parallax() const { return at<ParallaxRec>(header().parallax); }
+    const CellRec *cells() const { return at<CellRec>(header().cells); }
+    const quint32 *cellShapes() const { return at<quint32>(header().cellShapes); }
+
+    QString string(quint32 i) const {
+        if (i >= header().strings.count) return QString();
+        const StringRec &s = at<StringRec>(header().strings)[i];
+        if (qint64(s.offset) + s.size > m_size) return QString();
+        return QString::fromUtf8(reinterpret_cast<const char *>(m_data + s.offset), s.size);
+    }
+
+private:
+    template<class T> const T *at(const Section &s) const { return reinterpret_cast<const T *>(m_data + s.offset); }
+    bool inside(const Section &s, size_t rec) const {
+        return s.offset % 8 == 0 && qint64(s.offset) + qint64(s.count) * qint64(rec) <= m_size;
+    }
+
+    const uchar *m_data;
+    qint64 m_size;
+};
+
+}
+
+#endif // LEVELFORMAT_H
@@ -0,0 +1,152 @@
+#include "levelreader.h"
+#include "jsonreader.h"
+
+namespace {
+
+// [a, b] pairs used by parallax "off"/"rate"
+QPointF readPair(JsonReader &r) {
+    QPointF p;
+    if (!r.beginArray()) return p;
+    for (int i = 0; r.nextElement(); ++i) {
+        if (i == 0) p.setX(r.readDouble());
+        else if (i == 1) p.setY(r.readDouble());
+        else r.skip();
+    }
+    return p;
+}
+
+// Legacy [x, y, w, h] integer rects
+QRectF readIntRect(JsonReader &r) {
+    int v[4] = {0, 0, 0, 0};
+    if (!r.beginArray()) return QRectF();
+    for (int i = 0; r.nextElement(); ++i) {
+        if (i < 4) v[i] = r.readInt();
+        else r.skip();
+    }
+    return QRectF(v[0], v[1], v[2], v[3]);
+}
+
+Shape readShape(JsonReader &r) {
+    Shape it; it.id = Symbol::intern(u"dummy"); it.shape = Shape::Rect;
+    if (!r.beginObject()) return it;
+    while (r.nextKey()) {
+        if (r.key("id")) it.id = Symbol::intern(r.readString("dummy"));
+        else if (r.key("shape")) {
+            const QString s = r.readString("rect");
+            it.shape = s == "rect" ? Shape::Rect : (s == "tri_left" ? Shape::TriLeft : Shape::TriRight);
+        }
+        else if (r.key("is_wall")) it.isWall = r.readBool(false);
+        else if (r.key("rect")) it.rect = r.readRect();
+        else r.skip();
+    }
+    return it;
+}
+
+Area readArea(JsonReader &r) {
+    Area ar; ar.id = Symbol::intern(u"dummy"); ar.title = QString::fromUtf8("øf");
+    if (!r.beginObject()) return ar;
+    while (r.nextKey()) {
+        if (r.key("id")) ar.id = Symbol::intern(r.readString("dummy"));
+        else if (r.key("title")) ar.title = r.readString(QString::fromUtf8("øf"));
+        else if (r.key("script")) ar.script = r.readString();
+        else if (r.key("rect")) ar.rect = r.readRect();
+        else r.skip();
+    }
+    return ar;
+}
+
+EnemySpawn readEnemy(JsonReader &r) {
+    EnemySpawn e;
+    if (!r.beginObject()) return e;
+    while (r.nextKey()) {
+        if (r.key("type")) e.type = r.readString();
+        else if (r.key("pos")) e.pos = r.readPoint();
+        else if (r.key("facing")) e.facingLeft = r.readString("left") != "right";
+        else r.skip();
+    }
+    return e;
+}
+
+Image readImage(JsonReader &r) {
+    Image s;
+    if (!r.beginObject()) return s;
+    while (r.nextKey()) {
+        if (r.key("id")) s.id = Symbol::intern(r.readString());
+        else if (r.key("path")) s.path = Symbol::intern(r.readString());
+        else if (r.key("z")) s.z = r.readDouble(0);
+        else if (r.key("pos")) s.tf.pos = r.readPoint();
+        else if (r.key("rotation")) s.tf.rotation = r.readDouble(0);
+        else if (r.key("scaleX")) s.tf.scaleX = r.readDouble(1.0);
+        else if (r.key("scaleY")) s.tf.scaleY = r.readDouble(1.0);
+        else r.skip();
+    }
+    return s;
+}
+
+LevelParallax readParallax(JsonReader &r) {
+    LevelParallax g;
+    if (!r.beginObject()) return g;
+    while (r.nextKey()) {
+        if (r.key("image")) g.image = r.readString();
+        else if (r.key("off")) g.off = readPair(r);
+        else if (r.key("rate")) g.rate = readPair(r);
+        else if (r.key("scale")) g.scale = r.readDouble();
+        else if (r.key("z")) g.z = r.readInt();
+        else if (r.key("wrap")) g.wrap = r.readBool();
+        else r.skip();
+    }
+    return g;
+}
+
+Shape readPlatform(JsonReader &r) {
+    int x = 0, y = 0, w = 0, h = 0;
+    if (r.beginObject()) {
+        while (r.nextKey()) {
+            if (r.key("x")) x = r.readInt();
+            else if (r.key("y")) y = r.readInt();
+            else if (r.key("width")) w = r.readInt();
+            else if (r.key("height")) h = r.readInt();
+            else r.skip();
+        }
+    }
+    Shape f; f.shape = Shape::Rect; f.rect = QRect(x, y, w, h);
+    return f;
+}
+
+}
+
+bool readLevel(const QByteArray &json, LevelData &level, QString *err) {
+    JsonReader r(json);
+    QList<Shape> platforms;
+    QRectF legacyWorld;
+
+    if (!r.beginObject()) { if (err) *err = "Root must be object"; return false; }
+    while (r.nextKey()) {
+        if (r.key("basePath")) level.basePath = r.readString(":assets/");
+        else if (r.key("world")) {
+            if (r.peek() == JsonReader::Array) legacyWorld = readIntRect(r);
+            else level.world = r.readRect();
+        }
+        else if (r.key("window")) level.window = r.readRect();
+        else if (r.key("interaction")) { if (r.beginArray()) while (r.nextElement()) level.shapes << readShape(r); }
+        else if (r.key("areas")) { if (r.beginArray()) while (r.nextElement()) level.areas << readArea(r); }
+        else if (r.key("enemies")) { if (r.beginArray()) while (r.nextElement()) level.enemies << readEnemy(r); }
+        else if (r.key("graphics")) { if (r.beginArray()) while (r.nextElement()) level.images << readImage(r); }
+        else if (r.key("parallax")) { if (r.beginArray()) while (r.nextElement()) level.parallax << readParallax(r); }
+        else if (r.key("bounds")) level.bounds = readIntRect(r);
+        else if (r.key("ground")) level.ground = r.readInt(550);
+        else if (r.key("platforms")) { if (r.beginArray()) while (r.nextElement()) platforms << readPlatform(r); }
+        else r.skip();
+    }
+    if (r.hasError()) { if (err) *err = r.errorString(); return false; }
+
+    // No interaction shapes: the old platforms-only format
+    level.legacy = level.shapes.isEmpty();
+    if (level.legacy) {
+        level.world = legacyWorld;
+        level.shapes = platforms;
+    } else {
+        level.bounds = level.world;
+    }
+    return true;
+}
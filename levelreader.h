@@ -0,0 +1,42 @@
+#ifndef LEVELREADER_H
+#define LEVELREADER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+
+#include "platform.h"
+
+// ------------------------------
+// Level JSON schema, read in one pass with JsonReader (no QJsonDocument).
+// Fills everything but pixels; Game resolves and decodes the art after.
+// Legacy levels ("platforms" instead of "interaction") come back with
+// legacy set and their platforms as plain rect shapes.
+// ------------------------------
+struct LevelParallax {
+    QString image;             // relative to the level directory
+    QPointF off, rate;
+    double scale = 0.0;
+    int z = 0;
+    bool wrap = false;
+};
+
+struct LevelData {
+    QString basePath = ":assets/";
+    QRectF world, window;
+    QList<Shape> shapes;
+    QList<Area> areas;
+    QList<EnemySpawn> enemies;
+    QList<Image> images;
+    QList<LevelParallax> parallax;
+
+    bool legacy = false;
+    QRectF bounds;             // legacy only
+    int ground = 550;          // legacy only
+};
+
+bool readLevel(const QByteArray &json, LevelData &level, QString *err = nullptr);
+
+#endif // LEVELREADER_H
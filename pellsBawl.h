@@ -6,89 +6,28 @@
 #include <cmath>
 
 #include "combo.h"
-#include "bezier.h"
+#include "projectilepool.h"
 #include "platform.h"
+#include "shapeindex.h"
+#include "sweep.h"
 #include "commander.h"
-
-struct Curve {
-    enum Type { Const, Sine, Linear } type = Const;
-
-    // const
-    double value = 0.0;
-
-    // sine
-    double amp = 0.0, phaseRad = 0.0, bias = 0.0;
-
-    // linear
-    double start = 0.0, end = 0.0;
-
-    double eval(double t, double duration) const {
-        switch (type) {
-        case Const:
-            return value;
-        case Sine: {
-            const double omega = (duration > 0.0) ? (2.0 * M_PI / duration) : 0.0;
-            return amp * std::sin(omega * t + phaseRad) + bias;
-        }
-        case Linear: {
-            if (duration <= 0.0) return end;            // safe fallback
-            const double u = t / duration;               // 0..1 over the clip
-            return start + (end - start) * u;
-        }
-        }
-        return 0.0;
-    }
-
-    static Curve fromJson(const QJsonValue& v) {
-        Curve c;
-        if (!v.isObject()) {
-            // allow bare numbers to act like const curves
-            c.type = Const;
-            c.value = v.toDouble(0.0);
-            return c;
-        }
-        const auto o = v.toObject();
-        const QString t = o.value("type").toString("const");
-
-        if (t == "const") {
-            c.type = Const;
-            c.value = o.value("value").toDouble(0.0);
-        } else if (t == "sine") {
-            c.type = Sine;
-            c.amp = o.value("amp").toDouble(0.0);
-            c.bias = o.value("bias").toDouble(0.0);
-            c.phaseRad = o.value("phaseDeg").toDouble(0.0) * M_PI / 180.0;
-        } else if (t == "linear") {
-            c.type = Linear;
-            c.start = o.value("start").toDouble(0.0);
-            c.end   = o.value("end").toDouble(c.start);
-        } else {
-            // unknown type → fallback to const 0
-            c.type = Const; c.value = 0.0;
-        }
-        return c;
-    }
-};
-
-struct Track {
-    QString id;
-    QPointF baseOffset{0,0};
-    Curve x, y, rot;
-    int zOrder = 1;
-    QPixmap pix;
-    QSizeF desiredSize; // logical pixels (DIPs)
-};
+#include "pellsBawlAnim.h"
 
 class PellsBawl : public QWidget {
     Q_OBJECT
 public:
     PellsBawl(QWidget *parent = nullptr) : QWidget(parent) {
         playerRect = QRect(100, 0, 50, 50); // Initial position of the player
+        stepFrom = playerRect;
 
         loadAnimation();
-        selectClip("walk");
+        selectClip(PellsBawlAnim::Walk);
     }
 
+    // Resource paths of the rig part images, for prefetching
+    static QStringList partPaths();
+    QList<QPixmap> pixmaps() const { return QList<QPixmap>(std::begin(m_pix), std::end(m_pix)); }
+
     void paintWalker(QPainter &p, qreal ground); //, QRectF r, bool turningLeft = false, const double m_animTime = .0);
     void drawShadow(QPainter& p, const QPointF& center, const QSizeF& size, double opacity) {
         QRadialGradient g(center, size.width()/2.0, center);
@@ -101,18 +40,21 @@ public:
         p.save(); p.setBrush(g); p.setPen(Qt::NoPen); p.drawPath(path); p.restore();
     }
     void paintHUD(QPainter &p) {
-        if (btw && isCharging()) btw->drawPowerBar(p);
+        if (isCharging()) ProjectilePool::drawPowerBar(p, m_charge, m_chargePulse);
     }
-    bool selectClip(const QString& id) {
-        auto it = m_clips.find(id);
-        if (it == m_clips.end()) return false;
-        m_activeClipId = id;
-        m_tracks       = it->tracks;
-        m_durationSec  = it->durationSec;
-        m_useFootCapsule = it->useFootCapsule;
+    // Switching clips cross-fades from the pose on screen over kFadeSec: the
+    // live pose buffer is frozen and the other one takes over.
+    void selectClip(PellsBawlAnim::ClipId id) {
+        const Anim::ClipDef& clip = PellsBawlAnim::kClips[id];
+        if (id != m_clip) {
+            if (m_fade > 0.0) m_livePose ^= 1; // else already frozen since the last switch
+            m_fade = 0.0;
+        }
+        m_clip           = id;
+        m_durationSec    = clip.durationSec;
+        m_useFootCapsule = clip.useFootCapsule;
         // m_animTime = 0.0; // optional: reset time on switch
         // update();
-        return true;
     }
 
     void setGravity(double newGravity) { gravity = newGravity; }
@@ -175,14 +117,31 @@ public:
         if(velocityY > 0) isFalling = true; else isFalling = false;
 
         // Update player position
+        stepFrom = playerRect;
         playerRect.moveLeft(playerRect.left() + velocityX);
         playerRect.moveTop(playerRect.top() + velocityY);
       }
     }
 
-    bool checkCollisions(QList<Shape> platforms, QRectF &bounds) {
+    bool checkCollisions(const QList<Shape> &platforms, const ShapeIndex &index, QRectF &bounds) {
         bool onGround = false;
-        for (auto platform : platforms) {
+
+        // At slope speeds a step can clear a thin platform or wall entirely.
+        // Stop just inside the first shape the step passed through and let
+        // the overlap response below handle it like any slow contact.
+        const QPointF step = playerRect.topLeft() - stepFrom.topLeft();
+        const Sweep::Hit passed = Sweep::first(stepFrom, step, platforms, index, [&](int i) {
+            return playerRect.intersects(platforms[i].rect);
+        });
+        if (passed.isHit())
+            playerRect.moveTopLeft(stepFrom.topLeft() + step * passed.toi - passed.normal * contactSkin);
+
+        // Responses below push playerRect by up to its own size, so look that
+        // far around it
+        ShapeIndex::Hits hits;
+        index.query(playerRect.adjusted(-playerRect.width(), -playerRect.height(), playerRect.width(), playerRect.height()), hits);
+        for (int i : hits) {
+            const Shape &platform = platforms[i];
             if (playerRect.intersects(platform.rect)) {
                 if(platform.isWall) {
                     if(playerRect.center().x() <= platform.rect.center().x())
@@ -280,7 +239,7 @@ public:
             playerRect.moveRight(qMin(sceneRect.right(), playerRect.right()));
         }
 
-        foreach (auto btw, shots) btw->checkCollisions(bounds, platforms);
+        m_cookies.checkCollisions(bounds, platforms, index);
 
         return onGround;
     }
@@ -300,9 +259,15 @@ public:
             }
         }
 
-        if (m_animDone && (m_finishAnim || !isLoop())) { selectClip("walk"); isThrowing = false; isJumping = false; m_finishAnim = false; }
+        if (m_animDone && (m_finishAnim || !isLoop())) { selectClip(PellsBawlAnim::Walk); isThrowing = false; isJumping = false; m_finishAnim = false; }
 
-        foreach (auto btw, shots) btw->onTick();
+        updatePose(dt);
+
+        if (m_charging) {
+            m_charge = std::min(1.0, m_charge + dt / m_chargeTimeSec);
+            m_chargePulse = std::fmod(m_chargePulse + dt * 2.0, 1.0);
+        }
+        m_cookies.tick(dt);
     }
 
     double durationSec() {
@@ -311,70 +276,50 @@ public:
 
     double velX() { return velocityX; }
     double velY() { return velocityY; }
+    void setVelocity(double vx, double vy) { velocityX = vx; velocityY = vy; }
     double jumping() { return isJumping; }
     bool faceLeft() { return isFacingLeft; }
     QRectF playerRectangle() { return playerRect; }
 private:
 
-    struct AnimClip {
-        QString id;
-        double durationSec = 1.0;
-        bool loop = true;
-        bool useFootCapsule = false;
-        QVector<Track> tracks;   // tracks for this clip (pixmaps are implicitly shared)
-    };
-
-    QHash<QString, AnimClip> m_clips;
-    QString m_activeClipId;
+    PellsBawlAnim::ClipId m_clip = PellsBawlAnim::kDefaultClip;
+    using RigPose = Anim::Pose<PellsBawlAnim::RoleCount>;
+    RigPose m_poses[2];              // live and, while fading, the frozen outgoing pose
+    int m_livePose = 0;
+    double m_fade = 1.0;             // cross-fade progress, 1 = done
+    static constexpr double kFadeSec = 0.15;
     bool m_useFootCapsule = false;   // read from active clip
-    QHash<QString, QPixmap> m_pixById; // loaded once per part id
+    QPixmap m_pix[PellsBawlAnim::RoleCount]; // loaded once per part
 
     bool m_finishAnim = false;
 
 private:
-    QVector<Track> m_tracks;
     double m_durationSec = 1.0;
     double m_globalScale = 1.25; // 1.0 = original size
     bool m_allPixLoaded = false;
     QElapsedTimer m_clock;
 
-    const Track* trackById(const QString& id) const {
-        for (const auto& tr : m_tracks) if (tr.id == id) return &tr;
-        return nullptr;
-    }
-
     bool isLoop() const {
-        return m_clips[m_activeClipId].loop;
-    }
-
-    static QPointF readPoint(const QJsonValue& v) {
-        const auto o = v.toObject();
-        return QPointF(o.value("x").toDouble(0.0), o.value("y").toDouble(0.0));
-    }
-    static QSizeF readSizeFromJson(const QJsonValue& v) {
-        if (v.isDouble()) { double s=v.toDouble(); return QSizeF(s,s); }
-        if (v.isObject()) {
-            auto o=v.toObject(); 
-            if (o.contains("w") && o.contains("h"))
-                return QSizeF(o.value("w").toDouble(), o.value("h").toDouble());
-        }
-        return QSizeF(); // invalid => use natural image size
+        return PellsBawlAnim::kClips[m_clip].loop;
     }
 
     void loadAnimation();
+    void evalPose(const Anim::ClipDef& clip, double t, RigPose& pose) const;
+    void updatePose(double dt);
 
 
-    void drawPixmapScaledCentered(QPainter& p, const Track& tr, const QPointF& pos, double rotDeg) {
-        if (tr.pix.isNull()) return;
+    void drawPixmapScaledCentered(QPainter& p, const Anim::TrackDef& tr, const QPointF& pos, double rotDeg) {
+        const QPixmap& pix = m_pix[tr.role];
+        if (pix.isNull()) return;
 
         // Natural size in *logical* pixels
-        const qreal dpr = tr.pix.devicePixelRatio();
-        const QSizeF natural = tr.pix.size() / dpr;
+        const qreal dpr = pix.devicePixelRatio();
+        const QSizeF natural = pix.size() / dpr;
 
         // Desired size (fallback to natural if not specified)
-        const QSizeF desired = (!tr.desiredSize.isValid() || tr.desiredSize.isEmpty())
+        const QSizeF desired = (tr.w <= 0.0 || tr.h <= 0.0)
                                  ? natural
-                                 : tr.desiredSize;
+                                 : QSizeF(tr.w, tr.h);
 
         const qreal sx = desired.width()  / qMax(1.0, natural.width());
         const qreal sy = desired.height() / qMax(1.0, natural.height());
@@ -384,7 +329,7 @@ private:
         p.rotate(rotDeg);
         p.scale(sx, sy);
         // draw centered at natural coordinates
-        p.drawPixmap(QPointF(-natural.width()/2.0, -natural.height()/2.0), tr.pix);
+        p.drawPixmap(QPointF(-natural.width()/2.0, -natural.height()/2.0), pix);
         p.restore();
     }
 
@@ -405,52 +350,45 @@ public:
             if (canDoubleJump) {
                 canJump = false;  canDoubleJump = false;
                 velocityY -= doubleJumpVelocity;
-                selectClip("jump_spin");
+                selectClip(PellsBawlAnim::JumpSpin);
             } else {
                 velocityY = -jumpVelocity;
-                selectClip("jump_straight");
+                selectClip(PellsBawlAnim::JumpStraight);
             }
             isJumping = true;
         }
         if (m_onGround) canDoubleJump = true;
         m_onGround = false;
     }
+    // Charges until released; pressing again restarts the charge
     void keyThrow() {
-        if (btw) { // must be thrown by release
-        // qDebug() << "Yikes!";
-            shots.removeAll(btw);
-            btw = nullptr;
-        }
-        btw = new BezierThrowWidget(this);
-        if (btw) {
-            QObject::connect(btw, &BezierThrowWidget::hasHit, this, [&](Shape *s){
-                // qDebug() << "hit:" << (s ? s->id : "bounds");
-                shots.removeAll(sender());
-            });
-            shots.append(btw);
-            btw->handleSpaceDown(playerRect.center());
-        }
+        m_charging = true;
+        m_charge = 0.0;
+        m_chargePulse = 0.0;
     }
-    bool isCharging() { return btw && btw->isCharging(); }
+    bool isCharging() { return m_charging; }
+    const ProjectilePool &cookies() const { return m_cookies; }
 
     void release(){
         isMovingLeft = false;
         isMovingRight = false;
     }
     void releaseThrowKey() {
-        selectClip("throw");
+        selectClip(PellsBawlAnim::Throw);
         m_returnToWalk = true;
         m_animTime = 0.0;
         isThrowing = true;
 
-        if(btw) {
-            btw->handleSpaceRelease(playerRect.center() - QPoint(0, 50), isFacingLeft);
-            btw = nullptr;
+        if (m_charging) {
+            m_cookies.launch(playerRect.center() - QPointF(0, 50), isFacingLeft, m_charge);
+            m_charging = false;
         }
     }
 
 private:
     QRectF playerRect;
+    QRectF stepFrom;              // playerRect before this tick's move
+    const qreal contactSkin = 0.5; // how far a swept stop sinks into the shape
 
     bool isJumping = false;
     bool isMovingLeft = false;
@@ -469,8 +407,11 @@ private:
 
     bool onAngularSurface = false;
 
-    QVector<BezierThrowWidget *> shots;
-    BezierThrowWidget *btw = nullptr;
+    ProjectilePool m_cookies;
+    bool m_charging = false;
+    double m_charge = 0.0;          // 0..1
+    double m_chargePulse = 0.0;     // power bar pulse, 0..1
+    double m_chargeTimeSec = 1.2;   // time to fill from 0 to 1
 
     // in WalkerWidget:
     double m_playbackRate = 1.0;   // 1.0 = normal speed
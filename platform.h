@@ -2,8 +2,11 @@
 #define PLATFORM_H
 #include <QRect>
 #include <QImage>
+#include <type_traits>
 
-typedef QString Id;
+#include "symbol.h"
+
+typedef Symbol Id; // interned at load
 
 struct Transform {
     QPointF pos{0,0};
@@ -19,18 +22,22 @@ struct Shape {
     QRectF rect; // used if rect
     bool isWall = false;
     bool operator==(const Shape &b) const {
-        return !id.compare(b.id);
+        return id == b.id;
     }
 };
+// Copied around the collision code by value
+static_assert(std::is_trivially_copyable<Shape>::value, "Shape must stay plain data");
 
 struct Image {
     Id id;
-    QString path;   // disk path
-    QImage img;     // loaded image
+    Symbol path;    // disk path, as written in the level
+    QImage img;     // loaded image, decoded at its on-screen size
+    QSizeF size;    // native size, used for layout
     Transform tf;
     qreal z = 0;    // for future sorting
+    bool isWall = false; // id names a wall, opened with the wall shapes
     bool operator==(const Image &b) const {
-        return !id.compare(b.id);
+        return id == b.id;
     }
 };
 
@@ -38,6 +45,13 @@ struct Area {
     Id id;
     QRectF rect;
     QString title;
+    QString script;   // see script.h
+};
+
+struct EnemySpawn {
+    QString type;   // kind, see EnemyTypes
+    QPointF pos;    // where its feet go (bottom middle)
+    bool facingLeft = true;
 };
 
 
@@ -1,34 +1,134 @@
-QT=widgets openglwidgets
-QT += multimedia
+QT=widgets opengl openglwidgets
+QT += multimedia concurrent
 SOURCES=main.cpp \
     Game.cpp \
+    arena.cpp \
+    assets.cpp \
+    bundles.cpp \
     combo.cpp \
+    diskcache.cpp \
+    entities.cpp \
     fighter.cpp \
     fighterAI.cpp \
     joystick.cpp \
-    pellsBawl.cpp
+    jsonreader.cpp \
+    levelreader.cpp \
+    pellsBawl.cpp \
+    projectilepool.cpp \
+    qoi.cpp \
+    script.cpp \
+    shapeindex.cpp \
+    startup.cpp \
+    sweep.cpp \
+    symbol.cpp \
+    texturestream.cpp \
+    triggers.cpp
 HEADERS=\
     Game.h \
+    anim.h \
+    arena.h \
+    assets.h \
     bezier.h \
+    bundles.h \
     combo.h \
     commander.h \
+    diskcache.h \
+    ecs.h \
+    entities.h \
     fighter.h \
     fighterAI.h \
     joystick.h \
+    jsonreader.h \
+    levelformat.h \
+    levelreader.h \
     pellsBawl.h \
-    platform.h
+    platform.h \
+    projectilepool.h \
+    qoi.h \
+    script.h \
+    shapeindex.h \
+    slotmap.h \
+    startup.h \
+    sweep.h \
+    symbol.h \
+    texturestream.h \
+    triggers.h
 RESOURCES=\
-    alf.qrc \
     intro.qrc \
-    level1.qrc \
-    level2.qrc \
-    levelart.qrc \
     levels.qrc \
-    mt2.qrc \
     pb.qrc
+# Level and fighter art. Compiled in by default; with CONFIG+=external_assets
+# each becomes bundles/<name>.rcc next to the executable and is mapped at
+# runtime by the level that needs it (see bundles.h).
+ART_BUNDLES = alf level1 level2 levelart mt2
 CONFIG+=c++17
 
+external_assets {
+    DEFINES += EXTERNAL_ASSETS
+    BUNDLE_DIR = $$OUT_PWD/bundles
+    for(b, ART_BUNDLES) {
+        rcc_$${b}.target = $$BUNDLE_DIR/$${b}.rcc
+        rcc_$${b}.depends = $$PWD/$${b}.qrc
+        rcc_$${b}.commands = $$sprintf($$QMAKE_MKDIR_CMD, $$shell_path($$BUNDLE_DIR)) $$escape_expand(\n\t) \
+            $$shell_path($$[QT_HOST_LIBEXECS]/rcc) -binary $$shell_path($$PWD/$${b}.qrc) -o $$shell_path($$BUNDLE_DIR/$${b}.rcc)
+        QMAKE_EXTRA_TARGETS += rcc_$${b}
+        PRE_TARGETDEPS += $$BUNDLE_DIR/$${b}.rcc
+    }
+} else {
+    for(b, ART_BUNDLES): RESOURCES += $${b}.qrc
+}
+
+# Compiled levels (see levelformat.h). tools/levelc is built for the host and
+# turns each level's JSON into a .pbl, rebuilt whenever the JSON changes, so a
+# .pbl never outlives an edit. They are plain files under levels/ next to the
+# executable, at the JSON's resource path (levels/assets/<level>/<name>.pbl),
+# so Game maps them straight from disk; rcc would compress and misalign them.
+LEVELS = assets/level1/level1_wportal.json assets/level2/level2.json assets/testlevel/test.json
+LEVELC_DIR = $$OUT_PWD/tools/levelc
+win32: LEVELC = $$LEVELC_DIR/levelc.exe
+else: LEVELC = $$LEVELC_DIR/levelc
+LEVEL_DIR = $$OUT_PWD/levels
+
+levelc.target = $$LEVELC
+levelc.depends = $$PWD/tools/levelc/main.cpp $$PWD/tools/levelc/levelc.pro $$PWD/levelformat.h
+levelc.commands = $$sprintf($$QMAKE_MKDIR_CMD, $$shell_path($$LEVELC_DIR)) $$escape_expand(\n\t) \
+    cd $$shell_path($$LEVELC_DIR) && $$shell_path($$QMAKE_QMAKE) CONFIG-=debug_and_release $$shell_path($$PWD/tools/levelc/levelc.pro) && $(MAKE)
+QMAKE_EXTRA_TARGETS += levelc
+
+LEVELS_PBL =
+for(j, LEVELS) {
+    pbl = $$replace(j, \.json$, .pbl)
+    pbl_dir = $$LEVEL_DIR/$$dirname(pbl)
+    name = pbl_$$replace(j, [/.], _)
+    $${name}.target = $$LEVEL_DIR/$$pbl
+    $${name}.depends = $$PWD/$$j $$LEVELC
+    $${name}.commands = $$sprintf($$QMAKE_MKDIR_CMD, $$shell_path($$pbl_dir)) $$escape_expand(\n\t) \
+        $$shell_path($$LEVELC) -o $$shell_path($$LEVEL_DIR/$$pbl) $$shell_path($$PWD/$$j)
+    QMAKE_EXTRA_TARGETS += $$name
+    LEVELS_PBL += $$LEVEL_DIR/$$pbl
+}
+PRE_TARGETDEPS += $$LEVELS_PBL
+
+# Image manifest (see Assets::resolve). tools/manifest is built for the host
+# and resolves every level image against the .qrc files into manifest.json
+# next to the executable, rebaked whenever a .qrc, a level or any art changes.
+MANIFEST_DIR = $$OUT_PWD/tools/manifest
+win32: MANIFEST_TOOL = $$MANIFEST_DIR/manifest.exe
+else: MANIFEST_TOOL = $$MANIFEST_DIR/manifest
+
+manifest_tool.target = $$MANIFEST_TOOL
+manifest_tool.depends = $$PWD/tools/manifest/main.cpp $$PWD/tools/manifest/manifest.pro
+manifest_tool.commands = $$sprintf($$QMAKE_MKDIR_CMD, $$shell_path($$MANIFEST_DIR)) $$escape_expand(\n\t) \
+    cd $$shell_path($$MANIFEST_DIR) && $$shell_path($$QMAKE_QMAKE) CONFIG-=debug_and_release $$shell_path($$PWD/tools/manifest/manifest.pro) && $(MAKE)
+
+manifest_json.target = $$OUT_PWD/manifest.json
+manifest_json.depends = $$MANIFEST_TOOL $$files($$PWD/*.qrc) $$files($$PWD/assets/*, true)
+manifest_json.commands = $$shell_path($$MANIFEST_TOOL) $$shell_path($$PWD) $$shell_path($$OUT_PWD/manifest.json)
+QMAKE_EXTRA_TARGETS += manifest_tool manifest_json
+PRE_TARGETDEPS += $$OUT_PWD/manifest.json
+
 
+include($$PWD/tools/animc/animc.pri)
 include($$PWD/external/QJoysticks/QJoysticks.pri)
 
 # # --- Fix SDL2 linkage for MinGW x64 ---
@@ -46,4 +146,5 @@ unix: LIBS += -L/usr/local/lib -lQJoysticks
 
 DISTFILES += \
     TODO-VISION.md \
+    assets/pb/pellsBawl.anim.json \
     joystick.md
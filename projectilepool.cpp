@@ -0,0 +1,169 @@
+#include <QPainterPath>
+#include <cmath>
+
+#include "projectilepool.h"
+#include "sweep.h"
+
+namespace {
+
+double lerp(double a, double b, double t) { return a + (b - a) * t; }
+double easeOutQuad(double t) { return 1.0 - (1.0 - t) * (1.0 - t); }
+
+const double kMaxFlight = 16.0;      // in curve t, for bounds it never leaves
+const double kSpriteSize = 64.0;     // logical px, at the global scale below
+const double kGlobalScale = 1.0 / 0.7;
+const double kOversample = 2.0;      // sprite resolution over its logical size
+
+// The heart cookie in a square pixmap, its middle on the cookie's origin
+QPixmap cookieSprite() {
+    const double scale = kGlobalScale * kSpriteSize / 100.0 * kOversample;
+    const int side = int(std::ceil(160.0 * scale));     // the path stays within +-80 units
+    QPixmap pm(side, side);
+    pm.fill(Qt::transparent);
+
+    QPainter p(&pm);
+    p.setRenderHint(QPainter::Antialiasing, true);
+    p.translate(side / 2.0, side / 2.0);
+    p.scale(scale, scale);
+
+    const QColor dough(214,173,117);
+    const QColor crust(176,129,71);
+    const QColor chip(77,50,35);
+
+    QPainterPath heart;
+    heart.moveTo(0, -20);
+    heart.cubicTo(-50, -80, -50, -10, 0, 20);
+    heart.cubicTo(50, -10, 50, -80, 0, -20);
+
+    p.setPen(QPen(crust, 3));
+    p.setBrush(dough);
+    p.drawPath(heart);
+
+    p.setBrush(chip);
+    p.setPen(Qt::NoPen);
+    p.drawEllipse(QRectF(-20, -30, 10, 8));
+    p.drawEllipse(QRectF(10, -10, 12, 9));
+    p.drawEllipse(QRectF(-5,  0, 9, 7));
+    return pm;
+}
+
+}
+
+// ------------------------------
+// Flights
+// ------------------------------
+int ProjectilePool::launch(const QPointF &origin, bool facingLeft, double charge01) {
+    int i;
+    if (!m_free.isEmpty()) { i = m_free.takeLast(); m_items[i] = Projectile(); }
+    else { i = m_items.size(); m_items.push_back(Projectile()); }
+
+    // Reach, landing height, apex and its skew, and flight time all grow
+    // with the charge
+    Projectile &pr = m_items[i];
+    pr.state = Projectile::Flying;
+    pr.facingLeft = facingLeft;
+    pr.origin = origin;
+    const double dx = 400.0 + (1100.0 - 400.0) * easeOutQuad(charge01);
+    pr.p2 = QPointF(dx, lerp(60.0, 0.0, charge01));
+    pr.p1 = makeControlPoint(QPointF(), pr.p2, lerp(90.0, 220.0, charge01), lerp(0.48, 0.60, charge01));
+    pr.durationSec = lerp(0.20, 0.80, 0.25 + 0.75 * charge01);
+    return i;
+}
+
+void ProjectilePool::tick(double dt) {
+    for (Projectile &pr : m_items) {
+        if (pr.state != Projectile::Flying) continue;
+        pr.t += dt / pr.durationSec;
+        pr.angleDeg += pr.spinDegPerSec * dt;
+    }
+}
+
+void ProjectilePool::clear() {
+    m_items.clear();
+    m_free.clear();
+    m_hits.clear();
+}
+
+// ------------------------------
+// Collisions
+// ------------------------------
+void ProjectilePool::schedule(Projectile &pr, const QRectF &bounds, const QList<Shape> &shapes, const ShapeIndex &index) {
+    // Power form of the flight in level space: a t^2 + b t + c
+    const QPointF a = pr.toWorld(pr.p2 - 2.0 * pr.p1), b = pr.toWorld(2.0 * pr.p1), c = pr.origin;
+    const double leave = Sweep::leaveTime(bounds, a, b, c, pr.t, pr.t + kMaxFlight);
+    const Sweep::Hit hit = Sweep::curve(a, b, c, pr.t, leave, shapes, index);
+    pr.hitT = hit.toi;
+    pr.hitShape = hit.shape;
+    pr.hitNormal = hit.normal;
+    pr.scheduled = true;
+    pr.scheduledFor = index.generation();
+}
+
+// Solved once per flight, again from the current t if the level's shapes
+// change meanwhile (the generation moves on)
+void ProjectilePool::checkCollisions(const QRectF &bounds, const QList<Shape> &shapes, const ShapeIndex &index) {
+    m_hits.clear();
+    const quint32 generation = index.generation();
+    for (int i = 0; i < m_items.size(); ++i) {
+        Projectile &pr = m_items[i];
+        if (pr.state != Projectile::Flying) continue;
+        if (!pr.scheduled || pr.scheduledFor != generation) schedule(pr, bounds, shapes, index);
+        if (pr.t < pr.hitT) continue;
+
+        m_hits.push_back(ProjectileHit{ i, pr.hitShape, pr.impactPos(), pr.hitNormal });
+        pr.state = Projectile::Free;
+        m_free.push_back(i);
+    }
+}
+
+// ------------------------------
+// Painting
+// ------------------------------
+void ProjectilePool::paint(QPainter &p) {
+    if (activeCount() == 0) return;
+    if (m_sprite.isNull()) m_sprite = cookieSprite();
+
+    // Mirrored cookies turn the other way: M * R(a) == R(-a) * M
+    const QRectF source(m_sprite.rect());
+    const double s = 1.0 / kOversample;
+    m_fragments.clear();
+    for (const Projectile &pr : m_items) {
+        if (pr.state != Projectile::Flying) continue;
+        m_fragments.push_back(QPainter::PixmapFragment::create(pr.position(), source,
+            pr.facingLeft ? -s : s, s, pr.facingLeft ? -pr.angleDeg : pr.angleDeg));
+    }
+    p.save();
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    p.drawPixmapFragments(m_fragments.constData(), m_fragments.size(), m_sprite);
+    p.restore();
+}
+
+void ProjectilePool::drawPowerBar(QPainter& p, double fill01, double pulse01) {
+    p.save();
+    p.resetTransform();
+
+    double scale = p.window().width() / 800.0;
+    const double x = 10.0 * scale, y = 50 * scale, w = 280 * scale, h = 16 * scale;
+
+    // frame
+    p.setPen(QPen(QColor(0x475569), 1.0 * scale));
+    p.setBrush(QColor(0,0,0,40));
+    p.drawRoundedRect(QRectF(x, y, w, h), 4, 4);
+
+    // fill, pulsing around green while charging
+    const double innerPad = 2.0;
+    const double fw = (w - 2*innerPad) * fill01;
+    QRectF fillRect(x + innerPad, y + innerPad, fw, h - 2*innerPad);
+    const double pulse = 0.5 + 0.5*std::sin(pulse01*2*M_PI);
+    p.setBrush(QColor::fromHslF(0.32, 0.68, 0.45 + 0.15*pulse));
+    p.setPen(Qt::NoPen);
+    p.drawRoundedRect(fillRect, 3, 3);
+
+    // percent text
+    p.setPen(QColor(0xcbd5e1));
+    p.setFont(QFont("Monospace", 9 * scale, QFont::DemiBold));
+    QString pct = QString("%1%").arg(int(std::round(fill01*100)));
+    p.drawText(QRect(x, y-1, w, h), Qt::AlignCenter, pct);
+
+    p.restore();
+}
@@ -0,0 +1,86 @@
+#ifndef PROJECTILEPOOL_H
+#define PROJECTILEPOOL_H
+
+#include <QList>
+#include <QPainter>
+#include <QPixmap>
+#include <QRectF>
+#include <QVector>
+
+#include "bezier.h"
+#include "platform.h"
+#include "shapeindex.h"
+
+// ------------------------------
+// PellsBawl's thrown cookies. Plain structs in one array, advanced in one
+// loop and drawn with a single drawPixmapFragments call from a sprite that
+// is rendered once. Slots of finished cookies are reused, so memory stays
+// at the most cookies ever in the air at once.
+//
+// A flight is a quadratic Bézier fixed at launch. checkCollisions solves
+// each new cookie's hit against the level once (Sweep::curve) and after
+// that only compares t; hits are collected into hits() rather than
+// signalled. Game drains them after each check and leaves crumbs where
+// cookies land.
+// ------------------------------
+struct Projectile {
+    enum State : quint8 { Free, Flying };
+
+    State state = Free;
+    bool facingLeft = false;     // the curve is mirrored in x
+    bool scheduled = false;      // hitT/hitShape are solved
+    QPointF origin;              // level coordinates of P0
+    QPointF p1, p2;              // control and end point, curve space (P0 = 0)
+    double t = 0.0;              // 0..1 over durationSec, keeps going past 1
+    double durationSec = 0.5;
+    double angleDeg = 0.0;
+    double spinDegPerSec = 1200.0;
+
+    quint32 scheduledFor = 0;    // ShapeIndex::generation() it was solved against
+    double hitT = 0.0;
+    int hitShape = -1;           // -1 leaves the bounds
+    QPointF hitNormal;
+
+    QPointF toWorld(const QPointF &v) const { return QPointF(facingLeft ? -v.x() : v.x(), v.y()); }
+    QPointF positionAt(double at) const { return origin + toWorld(bezierPoint(at, QPointF(), p1, p2)); }
+    QPointF position() const { return positionAt(t); }
+    QPointF velocity() const { return toWorld(bezierTangent(t, QPointF(), p1, p2)) / durationSec; } // px/s
+    double impactIn() const { return (hitT - t) * durationSec; }                                  // seconds
+    QPointF impactPos() const { return positionAt(hitT); }
+};
+
+struct ProjectileHit {
+    int projectile;              // slot, already free again
+    int shape;                   // index into the level's shapes, -1 left the bounds
+    QPointF pos, normal;
+};
+
+class ProjectilePool {
+public:
+    // Throw from origin; charge01 sets reach, arc and flight time
+    int launch(const QPointF &origin, bool facingLeft, double charge01);
+    void tick(double dt);
+    void checkCollisions(const QRectF &bounds, const QList<Shape> &shapes, const ShapeIndex &index);
+    void paint(QPainter &p);
+    void clear();
+
+    // Every slot, Free ones included
+    const QVector<Projectile> &projectiles() const { return m_items; }
+    int activeCount() const { return m_items.size() - m_free.size(); }
+    // Hits found by the last checkCollisions, replaced by the next one
+    const QVector<ProjectileHit> &hits() const { return m_hits; }
+
+    static void drawPowerBar(QPainter &p, double fill01, double pulse01);
+
+private:
+    void schedule(Projectile &pr, const QRectF &bounds, const QList<Shape> &shapes, const ShapeIndex &index);
+
+    QVector<Projectile> m_items;
+    QVector<int> m_free;
+    QVector<ProjectileHit> m_hits;
+
+    QPixmap m_sprite;                                   // made on the first paint
+    QVector<QPainter::PixmapFragment> m_fragments;      // reused every paint
+};
+
+#endif // PROJECTILEPOOL_H
@@ -0,0 +1,161 @@
+#include <cstring>
+
+#include "qoi.h"
+
+namespace {
+
+const uchar kOpIndex = 0x00; // 00xxxxxx
+const uchar kOpDiff  = 0x40; // 01xxxxxx
+const uchar kOpLuma  = 0x80; // 10xxxxxx
+const uchar kOpRun   = 0xc0; // 11xxxxxx
+const uchar kOpRgb   = 0xfe;
+const uchar kOpRgba  = 0xff;
+const uchar kMask2   = 0xc0;
+
+const int kHeaderSize = 14;
+const uchar kPadding[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+const quint32 kMaxPixels = 400000000u; // same guard as the reference codec
+
+struct Px { uchar r, g, b, a; };
+
+inline int hash(const Px &p) { return (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) % 64; }
+
+inline quint32 read32(const uchar *p) {
+    return quint32(p[0]) << 24 | quint32(p[1]) << 16 | quint32(p[2]) << 8 | p[3];
+}
+
+inline void write32(QByteArray &out, quint32 v) {
+    out.append(char(v >> 24)); out.append(char(v >> 16)); out.append(char(v >> 8)); out.append(char(v));
+}
+
+}
+
+namespace Qoi {
+
+bool isQoi(const QByteArray &data) {
+    return data.size() >= kHeaderSize && data.startsWith("qoif");
+}
+
+QSize size(const QByteArray &data) {
+    if (!isQoi(data)) return QSize();
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    return QSize(int(read32(p + 4)), int(read32(p + 8)));
+}
+
+QImage decode(const QByteArray &data) {
+    if (!isQoi(data)) return QImage();
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    const quint32 w = read32(bytes + 4), h = read32(bytes + 8);
+    const int channels = bytes[12];
+    if (w == 0 || h == 0 || (channels != 3 && channels != 4) || h >= kMaxPixels / w) return QImage();
+
+    QImage img(int(w), int(h), channels == 4 ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+    if (img.isNull()) return img;
+
+    Px index[64];
+    std::memset(index, 0, sizeof(index));
+    Px px = {0, 0, 0, 255};
+    int run = 0;
+
+    const qsizetype end = data.size() - qsizetype(sizeof(kPadding));
+    qsizetype pos = kHeaderSize;
+    for (quint32 y = 0; y < h; ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(img.scanLine(int(y)));
+        for (quint32 x = 0; x < w; ++x) {
+            if (run > 0) {
+                --run;
+            } else if (pos < end) {
+                const uchar b1 = bytes[pos++];
+                if (b1 == kOpRgb) {
+                    px.r = bytes[pos]; px.g = bytes[pos + 1]; px.b = bytes[pos + 2];
+                    pos += 3;
+                } else if (b1 == kOpRgba) {
+                    px.r = bytes[pos]; px.g = bytes[pos + 1]; px.b = bytes[pos + 2]; px.a = bytes[pos + 3];
+                    pos += 4;
+                } else if ((b1 & kMask2) == kOpIndex) {
+                    px = index[b1];
+                } else if ((b1 & kMask2) == kOpDiff) {
+                    px.r += ((b1 >> 4) & 0x03) - 2;
+                    px.g += ((b1 >> 2) & 0x03) - 2;
+                    px.b += ( b1       & 0x03) - 2;
+                } else if ((b1 & kMask2) == kOpLuma) {
+                    const uchar b2 = bytes[pos++];
+                    const int vg = (b1 & 0x3f) - 32;
+                    px.r += vg - 8 + ((b2 >> 4) & 0x0f);
+                    px.g += vg;
+                    px.b += vg - 8 + (b2 & 0x0f);
+                } else { // kOpRun
+                    run = b1 & 0x3f;
+                }
+                index[hash(px)] = px;
+            }
+            line[x] = qPremultiply(qRgba(px.r, px.g, px.b, px.a));
+        }
+    }
+    return img;
+}
+
+QByteArray encode(const QImage &src) {
+    if (src.isNull()) return QByteArray();
+    const bool alpha = src.hasAlphaChannel();
+    // Non-premultiplied, as the format wants
+    const QImage img = src.convertToFormat(alpha ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+    const int w = img.width(), h = img.height();
+
+    QByteArray out;
+    out.reserve(kHeaderSize + qsizetype(w) * h * (alpha ? 5 : 4) / 2 + int(sizeof(kPadding)));
+    out.append("qoif", 4);
+    write32(out, quint32(w));
+    write32(out, quint32(h));
+    out.append(char(alpha ? 4 : 3));
+    out.append(char(0)); // sRGB with linear alpha
+
+    Px index[64];
+    std::memset(index, 0, sizeof(index));
+    Px prev = {0, 0, 0, 255};
+    int run = 0;
+    const qint64 last = qint64(w) * h - 1;
+
+    for (int y = 0; y < h; ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(img.constScanLine(y));
+        for (int x = 0; x < w; ++x) {
+            const QRgb c = line[x];
+            const Px px = { uchar(qRed(c)), uchar(qGreen(c)), uchar(qBlue(c)), uchar(alpha ? qAlpha(c) : 255) };
+
+            if (std::memcmp(&px, &prev, sizeof(Px)) == 0) {
+                ++run;
+                if (run == 62 || qint64(y) * w + x == last) { out.append(char(kOpRun | (run - 1))); run = 0; }
+                continue;
+            }
+            if (run > 0) { out.append(char(kOpRun | (run - 1))); run = 0; }
+
+            const int h64 = hash(px);
+            if (std::memcmp(&index[h64], &px, sizeof(Px)) == 0) {
+                out.append(char(kOpIndex | h64));
+            } else {
+                index[h64] = px;
+                if (px.a == prev.a) {
+                    const signed char vr = px.r - prev.r, vg = px.g - prev.g, vb = px.b - prev.b;
+                    const signed char vgr = vr - vg, vgb = vb - vg;
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                        out.append(char(kOpDiff | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+                    } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                        out.append(char(kOpLuma | (vg + 32)));
+                        out.append(char((vgr + 8) << 4 | (vgb + 8)));
+                    } else {
+                        out.append(char(kOpRgb));
+                        out.append(char(px.r)); out.append(char(px.g)); out.append(char(px.b));
+                    }
+                } else {
+                    out.append(char(kOpRgba));
+                    out.append(char(px.r)); out.append(char(px.g)); out.append(char(px.b)); out.append(char(px.a));
+                }
+            }
+            prev = px;
+        }
+    }
+    out.append(reinterpret_cast<const char *>(kPadding), sizeof(kPadding));
+    return out;
+}
+
+}
@@ -0,0 +1,29 @@
+#ifndef QOI_H
+#define QOI_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+
+// ------------------------------
+// QOI ("Quite OK Image") codec, https://qoiformat.org. Lossless, about the
+// size of PNG for our sprites and several times faster to decode, because
+// it is a single pass over the bytes with no inflate.
+//
+// Shipped sprites can be converted with tools/spriteconv; Assets picks up a
+// .qoi next to a .png/.jpg on its own, so callers keep using the old path.
+// ------------------------------
+namespace Qoi {
+
+bool isQoi(const QByteArray &data);
+// Size from the 14 byte header; invalid if data is not QOI
+QSize size(const QByteArray &data);
+
+// Decodes to ARGB32_Premultiplied (RGBA files) or RGB32 (RGB files).
+QImage decode(const QByteArray &data);
+// Encodes any image; alpha is written only if the image has an alpha channel.
+QByteArray encode(const QImage &img);
+
+}
+
+#endif // QOI_H
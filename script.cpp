@@ -0,0 +1,147 @@
+#include <QStringList>
+#include <QVarLengthArray>
+
+#include "script.h"
+
+namespace Script {
+
+namespace {
+
+struct Section {
+    QVector<Instr> code;
+    QVarLengthArray<int, 8> open;    // unclosed ifs
+};
+
+bool number(const QString &s, float &out) {
+    bool ok = false;
+    out = s.toFloat(&ok);
+    return ok;
+}
+
+bool variable(const QString &s, quint8 &out) {
+    static const char *const names[] = { "vx", "vy", "px", "py", "wx", "wy" };
+    for (quint8 i = 0; i < 6; ++i) if (s == QLatin1String(names[i])) { out = i; return true; }
+    return false;
+}
+
+bool comparison(const QString &s, quint8 &out) {
+    static const char *const names[] = { "<", "<=", ">", ">=", "==", "!=" };
+    for (quint8 i = 0; i < 6; ++i) if (s == QLatin1String(names[i])) { out = i; return true; }
+    return false;
+}
+
+double value(quint8 var, const State &s) {
+    switch (var) {
+    case VX: return s.velocity.x();
+    case VY: return s.velocity.y();
+    case PX: return s.player.x();
+    case PY: return s.player.y();
+    case WX: return s.window.left();
+    default: return s.window.top();
+    }
+}
+
+bool test(const Instr &in, const State &s) {
+    const double v = value(in.var, s), n = in.a;
+    switch (in.cmp) {
+    case Less: return v < n;
+    case LessEqual: return v <= n;
+    case Greater: return v > n;
+    case GreaterEqual: return v >= n;
+    case Equal: return v == n;
+    default: return v != n;
+    }
+}
+
+}
+
+// ------------------------------
+// Compiler
+// ------------------------------
+bool compile(const QString &source, Program &program, Entries &entries, QString *err) {
+    Section sections[3];             // enter, exit, inside
+    Section *current = &sections[0];
+    const QStringList lines = source.split('\n');
+    for (int n = 0; n < lines.size(); ++n) {
+        auto fail = [&](const QString &why) {
+            if (err) *err = QString("line %1: %2").arg(n + 1).arg(why);
+            return false;
+        };
+        QString line = lines[n];
+        const int hash = line.indexOf('#');
+        if (hash >= 0) line.truncate(hash);
+
+        for (const QString &statement : line.split(';')) {
+            const QStringList w = statement.simplified().split(' ', Qt::SkipEmptyParts);
+            if (w.isEmpty()) continue;
+            const QString &cmd = w.first();
+            Instr in;
+            auto args = [&](int count) {
+                return w.size() == count + 1 && (count < 1 || number(w[1], in.a)) && (count < 2 || number(w[2], in.b));
+            };
+
+            if (cmd == "enter:") { current = &sections[0]; continue; }
+            if (cmd == "exit:") { current = &sections[1]; continue; }
+            if (cmd == "inside:") { current = &sections[2]; continue; }
+            if (cmd == "scroll" && w.size() == 2 && (w[1] == "on" || w[1] == "off")) {
+                in.op = Scroll; in.on = w[1] == "on";
+            }
+            else if (cmd == "velocity" && args(2)) in.op = SetVelocity;
+            else if (cmd == "push" && args(2)) in.op = Push;
+            else if (cmd == "bounce" && args(1)) in.op = Bounce;
+            else if (cmd == "pan" && args(2)) in.op = Pan;
+            else if (cmd == "walls" && w.size() == 2 && (w[1] == "on" || w[1] == "off")) {
+                in.op = Walls; in.on = w[1] == "on";
+            }
+            else if (cmd == "nextlevel" && args(0)) in.op = NextLevel;
+            else if (cmd == "if") {
+                if (w.size() != 4 || !variable(w[1], in.var) || !comparison(w[2], in.cmp) || !number(w[3], in.a))
+                    return fail("expected if <var> <cmp> <number>");
+                in.op = If;
+                current->open.append(current->code.size());
+            }
+            else if (cmd == "end" && args(0)) {
+                if (current->open.isEmpty()) return fail("end without if");
+                const int i = current->open.takeLast();
+                current->code[i].skip = quint32(current->code.size() - i - 1);
+                continue;
+            }
+            else return fail("can't read '" + statement.simplified() + "'");
+            current->code.push_back(in);
+        }
+    }
+
+    for (const Section &s : sections)
+        if (!s.open.isEmpty()) { if (err) *err = "if without end"; return false; }
+
+    int *entry[3] = { &entries.enter, &entries.exit, &entries.inside };
+    for (int i = 0; i < 3; ++i) {
+        if (sections[i].code.isEmpty()) continue;
+        *entry[i] = program.size();
+        program += sections[i].code;
+        program.push_back(Instr());
+    }
+    return true;
+}
+
+// ------------------------------
+// Interpreter
+// ------------------------------
+void run(const Program &program, int entry, State &s) {
+    if (entry < 0) return;
+    for (const Instr *pc = program.constData() + entry; ; ++pc) {
+        switch (pc->op) {
+        case End: return;
+        case Scroll: s.scrolling = pc->on; break;
+        case SetVelocity: s.velocity = QPointF(pc->a, pc->b); break;
+        case Push: s.velocity += QPointF(pc->a, pc->b); break;
+        case Bounce: s.velocity *= -pc->a; break;
+        case Pan: s.window.translate(pc->a, pc->b); break;
+        case Walls: s.walls = pc->on; break;
+        case NextLevel: s.nextLevel = true; break;
+        case If: if (!test(*pc, s)) pc += pc->skip; break;
+        }
+    }
+}
+
+}
@@ -0,0 +1,83 @@
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+// ------------------------------
+// Level scripts: a few lines of commands a designer types into an area,
+// compiled once at level load into fixed-size instructions and run by a
+// loop that neither allocates nor looks anything up by name.
+//
+//   enter:                    # when the player walks in (the default)
+//     scroll off
+//     bounce 1.5              # vx, vy *= -1.5
+//     push 0 -8
+//   inside:                   # every tick while in the area
+//     if vx > 4
+//       push -0.5 0
+//     end
+//   exit:                     # when the player leaves
+//     scroll on
+//
+// Statements end at a newline or ';', '#' starts a comment.
+//   scroll on|off             follow the player or hold the window still
+//   velocity <vx> <vy>        set the player's velocity (px per tick)
+//   push <dx> <dy>            add to it
+//   bounce <k>                reverse it, scaled by k
+//   pan <dx> <dy>             move the window
+//   walls off|on              open or close the level's walls
+//   nextlevel                 go on to the next level
+//   if <var> <cmp> <n> ... end
+// vars: vx vy (player velocity), px py (player centre), wx wy (window
+// top-left); cmp: < <= > >= == !=
+//
+// There are no backward jumps, so every run ends after at most as many
+// steps as the section has instructions.
+// ------------------------------
+namespace Script {
+
+enum Op : quint8 { End, Scroll, SetVelocity, Push, Bounce, Pan, Walls, NextLevel, If };
+enum Var : quint8 { VX, VY, PX, PY, WX, WY };
+enum Cmp : quint8 { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+struct Instr {
+    Op op = End;
+    quint8 var = 0;              // If
+    quint8 cmp = 0;              // If
+    quint8 on = 0;               // Scroll, Walls
+    quint32 skip = 0;            // If: instructions to jump over when false
+    float a = 0.0f, b = 0.0f;
+};
+static_assert(sizeof(Instr) == 16, "keep instructions at 16 bytes");
+
+using Program = QVector<Instr>;
+
+// Where each section starts in the program, -1 if the source has none
+struct Entries {
+    int enter = -1, exit = -1, inside = -1;
+};
+
+// What a script sees and changes. The caller fills it in, runs any number
+// of scripts against it and applies it back; walls and nextLevel are
+// requests for the caller to carry out.
+struct State {
+    QPointF player;              // centre
+    QPointF velocity;            // px per tick
+    QRectF window;
+    bool scrolling = true;
+    qint8 walls = -1;            // 0 off, 1 on, -1 left alone
+    bool nextLevel = false;
+};
+
+// Appends the source's sections to program. On error program is left as it
+// was and err says where.
+bool compile(const QString &source, Program &program, Entries &entries, QString *err = nullptr);
+
+void run(const Program &program, int entry, State &state);
+
+}
+
+#endif // SCRIPT_H
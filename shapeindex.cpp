@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cmath>
+
+#include "shapeindex.h"
+#include "levelformat.h"
+
+namespace {
+// Keep pathological levels (one far-off shape) from allocating huge grids
+const int kMaxCells = 1 << 16;
+}
+
+// ------------------------------
+// Building
+// ------------------------------
+template<class F> void ShapeIndex::forCells(const QRectF &r, F f) const {
+    const int c0 = column(r.left()), c1 = column(r.right());
+    const int r0 = row(r.top()), r1 = row(r.bottom());
+    for (int y = r0; y <= r1; ++y)
+        for (int x = c0; x <= c1; ++x) f(y * m_cols + x);
+}
+
+void ShapeIndex::build(const QList<Shape> &shapes, double cellSize) {
+    clear();
+    if (shapes.isEmpty()) return;
+
+    // Span by hand: QRectF::united drops zero-area rects
+    double left = qInf(), top = qInf(), right = -qInf(), bottom = -qInf();
+    m_rects.reserve(shapes.size());
+    for (const Shape &s : shapes) {
+        const QRectF r = s.rect.normalized();
+        left = qMin(left, r.left()); top = qMin(top, r.top());
+        right = qMax(right, r.right()); bottom = qMax(bottom, r.bottom());
+        m_rects << r;
+    }
+    m_enabled.fill(1, m_rects.size());
+    m_cell = cellSize > 0.0 ? cellSize : 256.0;
+    while (true) {
+        m_x = std::floor(left / m_cell) * m_cell;
+        m_y = std::floor(top / m_cell) * m_cell;
+        m_cols = qMax(1, int(std::ceil((right - m_x) / m_cell)));
+        m_rows = qMax(1, int(std::ceil((bottom - m_y) / m_cell)));
+        if (qint64(m_cols) * m_rows <= kMaxCells) break;
+        m_cell *= 2.0;
+    }
+
+    // Counting sort into cells: count, prefix sum, fill
+    m_cellStart.fill(0, cellCount() + 1);
+    for (const QRectF &r : m_rects) forCells(r, [&](int c) { ++m_cellStart[c + 1]; });
+    for (int c = 0; c < cellCount(); ++c) m_cellStart[c + 1] += m_cellStart[c];
+    m_items.resize(m_cellStart.last());
+    QVector<int> next = m_cellStart;
+    for (int i = 0; i < m_rects.size(); ++i) forCells(m_rects[i], [&](int c) { m_items[next[c]++] = i; });
+    m_seen.fill(0, m_rects.size());
+}
+
+// The .pbl grid was built by levelc from the same shapes in the same order
+bool ShapeIndex::adopt(const QList<Shape> &shapes, const LevelFormat::View &level) {
+    const LevelFormat::Header &h = level.header();
+    if (h.cellSize <= 0.0 || h.cols == 0 || h.rows == 0 || qint64(h.cols) * h.rows > kMaxCells
+        || h.shapes.count != quint32(shapes.size())) {
+        return false;
+    }
+    const LevelFormat::CellRec *cells = level.cells();
+    const quint32 *items = level.cellShapes();
+    for (quint32 c = 0; c < h.cells.count; ++c) {
+        if (quint64(cells[c].first) + cells[c].count > h.cellShapes.count) return false;
+    }
+    for (quint32 i = 0; i < h.cellShapes.count; ++i) {
+        if (items[i] >= h.shapes.count) return false;
+    }
+
+    clear();
+    m_x = h.gridX; m_y = h.gridY; m_cell = h.cellSize;
+    m_cols = int(h.cols); m_rows = int(h.rows);
+    m_rects.reserve(shapes.size());
+    for (const Shape &s : shapes) m_rects << s.rect.normalized();
+    m_enabled.fill(1, m_rects.size());
+    m_cellStart.resize(cellCount() + 1);
+    m_items.reserve(int(h.cellShapes.count));
+    for (int c = 0; c < cellCount(); ++c) {
+        m_cellStart[c] = m_items.size();
+        for (quint32 k = 0; k < cells[c].count; ++k) m_items << int(items[cells[c].first + k]);
+    }
+    m_cellStart[cellCount()] = m_items.size();
+    m_seen.fill(0, m_rects.size());
+    return true;
+}
+
+void ShapeIndex::clear() {
+    ++m_generation;
+    m_cols = m_rows = 0;
+    m_cellStart.clear();
+    m_items.clear();
+    m_rects.clear();
+    m_enabled.clear();
+    m_extra.clear();
+    m_filed.clear();
+    m_seen.clear();
+    m_stamp = 0;
+}
+
+// ------------------------------
+// Changes
+// ------------------------------
+void ShapeIndex::insert(int i, const QRectF &rect) {
+    ++m_generation;
+    if (i >= m_rects.size()) {
+        m_rects.resize(i + 1);
+        m_enabled.resize(i + 1, 0);
+        m_seen.resize(i + 1, 0);
+    }
+    m_filed.resize(m_rects.size(), 0);
+    if (m_cols == 0) { // nothing built: one cell, the border takes the rest
+        const QRectF r = rect.normalized();
+        m_x = r.left(); m_y = r.top();
+        m_cols = m_rows = 1;
+        m_cellStart.fill(0, 2);
+    }
+    if (m_extra.isEmpty()) m_extra.resize(cellCount());
+
+    // A slot reused after the build may still sit in the built cells of its
+    // old rect; those entries only add candidates the overlap test turns down
+    if (m_filed[i]) forCells(m_rects[i], [&](int c) { m_extra[c].removeOne(i); });
+    m_rects[i] = rect.normalized();
+    m_enabled[i] = 1;
+    m_filed[i] = 1;
+    forCells(m_rects[i], [&](int c) { m_extra[c] << i; });
+}
+
+void ShapeIndex::setEnabled(int i, bool enabled) {
+    if (i < 0 || i >= m_enabled.size()) return;
+    ++m_generation;
+    m_enabled[i] = enabled;
+}
+
+int ShapeIndex::column(double x) const { return qBound(0, int(std::floor((x - m_x) / m_cell)), m_cols - 1); }
+int ShapeIndex::row(double y) const { return qBound(0, int(std::floor((y - m_y) / m_cell)), m_rows - 1); }
+
+// ------------------------------
+// Queries
+// ------------------------------
+void ShapeIndex::query(const QRectF &rect, Hits &out) const {
+    out.clear();
+    if (isEmpty()) return;
+    const QRectF q = rect.normalized();
+
+    if (++m_stamp == 0) { m_seen.fill(0); m_stamp = 1; }
+    auto test = [&](int i) {
+        if (m_seen[i] == m_stamp || !m_enabled[i]) return;
+        m_seen[i] = m_stamp;
+        const QRectF &r = m_rects[i];
+        if (r.left() <= q.right() && r.right() >= q.left() && r.top() <= q.bottom() && r.bottom() >= q.top())
+            out.append(i);
+    };
+    if (m_cols > 0) forCells(q, [&](int c) {
+        for (int k = m_cellStart[c]; k < m_cellStart[c + 1]; ++k) test(m_items[k]);
+        if (!m_extra.isEmpty()) for (int i : m_extra[c]) test(i);
+    });
+    std::sort(out.begin(), out.end());
+}
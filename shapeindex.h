@@ -0,0 +1,75 @@
+#ifndef SHAPEINDEX_H
+#define SHAPEINDEX_H
+
+#include <QList>
+#include <QRectF>
+#include <QVector>
+#include <QVarLengthArray>
+
+#include "platform.h"
+
+namespace LevelFormat { class View; }
+
+// ------------------------------
+// Static broadphase over a level's shapes: a uniform grid, the same layout
+// tools/levelc bakes into .pbl files (adopted as is for compiled levels).
+// Queries hand back shape indices into the list the index was built from,
+// each once and in list order, so callers keep their exact tests and the
+// response order they had when looping over every shape.
+//
+//   ShapeIndex::Hits hits;
+//   index.query(playerRect, hits);
+//   for (int i : hits) { const Shape &s = shapes[i]; ... }
+//
+// Overlap is tested on closed intervals, so degenerate query rects (a feet
+// segment, a point) still find shapes they touch. Anything outside the grid
+// falls into the border cells.
+//
+// Shapes can change after the build without one (see SlotMap): remove and
+// setEnabled only flip a flag the query checks, insert files the shape into
+// per-cell lists next to the built ones, so a query still only looks at the
+// cells it covers. The next build folds those in.
+// ------------------------------
+class ShapeIndex {
+public:
+    using Hits = QVarLengthArray<int, 32>;
+
+    void build(const QList<Shape> &shapes, double cellSize = 256.0);
+    bool adopt(const QList<Shape> &shapes, const LevelFormat::View &level);
+    void clear();
+
+    // Changes to shape i without a rebuild: O(1), insert O(cells covered)
+    void insert(int i, const QRectF &rect);
+    void remove(int i) { setEnabled(i, false); }
+    void setEnabled(int i, bool enabled);
+
+    void query(const QRectF &r, Hits &out) const;
+    void queryPoint(const QPointF &p, Hits &out) const { query(QRectF(p, p), out); }
+
+    bool isEmpty() const { return m_rects.isEmpty(); }
+    int cellCount() const { return m_cols * m_rows; }
+    // Bumped by every change; results kept from an older generation may
+    // refer to shapes that are gone or miss new ones
+    quint32 generation() const { return m_generation; }
+
+private:
+    int column(double x) const;
+    int row(double y) const;
+    template<class F> void forCells(const QRectF &r, F f) const;
+
+    double m_x = 0.0, m_y = 0.0, m_cell = 256.0;
+    int m_cols = 0, m_rows = 0;
+    quint32 m_generation = 0;
+    QVector<int> m_cellStart;          // cols * rows + 1, into m_items
+    QVector<int> m_items;
+    QVector<QRectF> m_rects;           // normalized copies, for the overlap test
+    QVector<quint8> m_enabled;         // by shape
+    QVector<QVector<int>> m_extra;     // by cell, inserted since the build
+    QVector<quint8> m_filed;           // by shape, sits in m_extra
+
+    // Shapes spanning several cells are reported once per query
+    mutable QVector<quint32> m_seen;
+    mutable quint32 m_stamp = 0;
+};
+
+#endif // SHAPEINDEX_H
@@ -0,0 +1,94 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <QList>
+#include <QVector>
+#include <QtGlobal>
+
+// ------------------------------
+// Level objects that can come and go while the level runs. Items stay in
+// their slot for life, so slot numbers (what ShapeIndex hands back) keep
+// meaning the same object; freed slots are reused by later inserts, and a
+// Handle carries the slot's generation so one kept past a remove doesn't
+// reach the newcomer.
+//
+//   Handle h = shapes.insert(shape);
+//   shapes.setEnabled(h, false);      // O(1), slot kept
+//   shapes.remove(h);                 // O(1), slot freed
+//   shapes.each([](int slot, const Shape &s) { ... });
+//
+// Nothing moves on remove, so removing or disabling from inside each() is
+// safe; inserts may reallocate and are not.
+// ------------------------------
+struct Handle {
+    quint32 slot = 0xffffffffu;
+    quint32 generation = 0;
+
+    bool isNull() const { return slot == 0xffffffffu; }
+    bool operator==(const Handle &b) const { return slot == b.slot && generation == b.generation; }
+    bool operator!=(const Handle &b) const { return !(*this == b); }
+};
+
+template<class T>
+class SlotMap {
+public:
+    Handle insert(const T &value) {
+        int i;
+        if (!m_free.isEmpty()) { i = m_free.takeLast(); m_items[i] = value; }
+        else { i = m_items.size(); m_items.push_back(value); m_generation.push_back(0); m_state.push_back(Free); }
+        m_state[i] = Enabled;
+        ++m_count;
+        return Handle{ quint32(i), m_generation[i] };
+    }
+
+    bool remove(Handle h) {
+        if (!contains(h)) return false;
+        const int i = int(h.slot);
+        m_items[i] = T();            // let go of what it holds now
+        m_state[i] = Free;
+        ++m_generation[i];
+        m_free.push_back(i);
+        --m_count;
+        return true;
+    }
+
+    bool setEnabled(Handle h, bool enabled) {
+        if (!contains(h)) return false;
+        m_state[h.slot] = enabled ? Enabled : Disabled;
+        return true;
+    }
+
+    bool contains(Handle h) const { return h.slot < quint32(m_items.size()) && m_state[h.slot] != Free && m_generation[h.slot] == h.generation; }
+    T *get(Handle h) { return contains(h) ? &m_items[h.slot] : nullptr; }
+    const T *get(Handle h) const { return contains(h) ? &m_items[h.slot] : nullptr; }
+
+    // By slot, for indices from a ShapeIndex and the like
+    Handle handle(int slot) const { return Handle{ quint32(slot), m_generation[slot] }; }
+    bool isEnabled(int slot) const { return m_state[slot] == Enabled; }
+    const T &operator[](int slot) const { return m_items[slot]; }
+    // Every slot, free ones default constructed
+    const QList<T> &slots() const { return m_items; }
+    int slotCount() const { return m_items.size(); }
+
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+    void reserve(int n) { m_items.reserve(n); m_generation.reserve(n); m_state.reserve(n); }
+    void clear() { m_items.clear(); m_generation.clear(); m_state.clear(); m_free.clear(); m_count = 0; }
+
+    // f(slot, item) for every enabled item, in slot order
+    template<class F> void each(F f) const {
+        for (int i = 0; i < m_items.size(); ++i)
+            if (m_state[i] == Enabled) f(i, m_items[i]);
+    }
+
+private:
+    enum State : quint8 { Free, Enabled, Disabled };
+
+    QList<T> m_items;
+    QVector<quint32> m_generation;
+    QVector<quint8> m_state;
+    QVector<int> m_free;
+    int m_count = 0;
+};
+
+#endif // SLOTMAP_H
@@ -0,0 +1,62 @@
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QDebug>
+
+#include "startup.h"
+
+Startup::Startup(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    for (int i = 0; i < PhaseCount; ++i) { m_begin[i] = -1; m_end[i] = -1; }
+}
+
+const char *Startup::name(Phase p) {
+    switch (p) {
+    case Splash:  return "splash";
+    case GL:      return "gl";
+    case Shaders: return "shaders";
+    case Decode:  return "decode";
+    case Audio:   return "audio";
+    default: break;
+    }
+    return "?";
+}
+
+void Startup::begin(Phase p) {
+    if (m_begin[p] < 0) m_begin[p] = m_clock.elapsed();
+}
+
+void Startup::end(Phase p) {
+    if (m_end[p] >= 0) return;
+    begin(p); // phases that never had an explicit begin start at their end
+    m_end[p] = m_clock.elapsed();
+    qDebug().noquote() << QString("startup: %1 %2 ms (done at %3 ms)")
+                              .arg(QLatin1String(name(p)), -8).arg(m_end[p] - m_begin[p]).arg(m_end[p]);
+
+    if (!m_reported && isReady()) {
+        m_reported = true;
+        qDebug().noquote() << QString("startup: time to interactive %1 ms").arg(m_end[p]);
+    }
+}
+
+bool Startup::isReady() const {
+    for (int i = 0; i < PhaseCount; ++i) if (m_end[i] < 0) return false;
+    return true;
+}
+
+void Startup::decodeInBackground(const QList<Assets::Request> &requests) {
+    begin(Decode);
+    auto *watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher]{
+        end(Decode);
+        watcher->deleteLater();
+    });
+    m_decode = QtConcurrent::run([requests]{ Assets::prefetch(requests); });
+    watcher->setFuture(m_decode);
+}
+
+void Startup::waitForDecode() {
+    if (m_decode.isValid()) m_decode.waitForFinished();
+    if (m_begin[Decode] >= 0) end(Decode);
+}
@@ -0,0 +1,43 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QStringList>
+
+#include "assets.h"
+
+// ------------------------------
+// Startup orchestrator. The splash goes up on the very first frame; GL set-up,
+// paint engine shader warm-up, asset decoding and audio warm-up run behind it.
+// Each phase is timed from Startup construction and logged, and once every
+// phase is done the time-to-interactive is logged as well.
+// ------------------------------
+class Startup : public QObject {
+    Q_OBJECT
+public:
+    enum Phase { Splash, GL, Shaders, Decode, Audio, PhaseCount };
+
+    explicit Startup(QObject *parent = nullptr);
+
+    void begin(Phase p);
+    void end(Phase p);
+
+    // Decode the given images on the thread pool (see Assets::prefetch).
+    void decodeInBackground(const QList<Assets::Request> &requests);
+    // Called before the first level is built so it finds everything decoded.
+    void waitForDecode();
+
+private:
+    static const char *name(Phase p);
+    bool isReady() const;
+
+    QElapsedTimer m_clock;
+    qint64 m_begin[PhaseCount];
+    qint64 m_end[PhaseCount];
+    bool m_reported = false;
+    QFuture<void> m_decode;
+};
+
+#endif // STARTUP_H
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "sweep.h"
+
+namespace {
+
+// Corners of a shape, 4 for rects, 3 for the slopes
+int outline(const Shape &s, QPointF *poly) {
+    const QRectF r = s.rect.normalized();
+    switch (s.shape) {
+    case Shape::Rect:
+        poly[0] = r.topLeft(); poly[1] = r.topRight(); poly[2] = r.bottomRight(); poly[3] = r.bottomLeft();
+        return 4;
+    case Shape::TriLeft:    // solid under the rise from bottom-left to top-right
+        poly[0] = r.bottomLeft(); poly[1] = r.topRight(); poly[2] = r.bottomRight();
+        return 3;
+    case Shape::TriRight:   // solid under the fall from top-left to bottom-right
+        poly[0] = r.topLeft(); poly[1] = r.bottomRight(); poly[2] = r.bottomLeft();
+        return 3;
+    }
+    return 0;
+}
+
+// Roots of a t^2 + b t + c in (lo, hi]
+int roots(double a, double b, double c, double lo, double hi, double *out) {
+    double r[2];
+    int n = 0;
+    if (qAbs(a) <= 1e-12 * qMax(1.0, qMax(qAbs(b), qAbs(c)))) {
+        if (b != 0.0) r[n++] = -c / b;
+    } else {
+        const double d = b * b - 4.0 * a * c;
+        if (d >= 0.0) {
+            // the form without cancellation for both roots
+            const double q = -0.5 * (b + std::copysign(std::sqrt(d), b));
+            r[n++] = q / a;
+            r[n++] = q != 0.0 ? c / q : 0.0;
+        }
+    }
+    int k = 0;
+    for (int i = 0; i < n; ++i)
+        if (r[i] > lo && r[i] <= hi) out[k++] = r[i];
+    return k;
+}
+
+// Start of the first stretch between consecutive times where the point is
+// where we're looking for it (checked at the midpoint), t1 if there is none
+template<class Wanted>
+double firstStretch(double *ts, int m, double t1, Wanted wanted) {
+    std::sort(ts, ts + m);
+    for (int k = 0; k + 1 < m; ++k) {
+        if (ts[k + 1] > ts[k] && wanted(0.5 * (ts[k] + ts[k + 1]))) return ts[k];
+    }
+    return t1;
+}
+
+inline QPointF at(const QPointF &a, const QPointF &b, const QPointF &c, double t) { return (a * t + b) * t + c; }
+
+// Projection of a polygon on an axis
+void project(const QPointF *pts, int n, const QPointF &axis, double *lo, double *hi) {
+    *lo = *hi = QPointF::dotProduct(pts[0], axis);
+    for (int i = 1; i < n; ++i) {
+        const double d = QPointF::dotProduct(pts[i], axis);
+        *lo = qMin(*lo, d); *hi = qMax(*hi, d);
+    }
+}
+
+}
+
+namespace Sweep {
+
+QRectF bounds(const QRectF &box, const QPointF &delta) {
+    const QRectF b = box.normalized();
+    return QRectF(QPointF(qMin(b.left(), b.left() + delta.x()), qMin(b.top(), b.top() + delta.y())),
+                  QPointF(qMax(b.right(), b.right() + delta.x()), qMax(b.bottom(), b.bottom() + delta.y())));
+}
+
+// Per axis the box is either already overlapping the shape's interval or
+// enters it at some t and leaves at a later one; the move hits when the
+// latest entry comes before the earliest exit. The axis of that latest
+// entry is the contact normal.
+bool shape(const QRectF &box, const QPointF &delta, const Shape &s, double *toi, QPointF *normal) {
+    QPointF poly[4];
+    const int n = outline(s, poly);
+    // x, y and for the slopes the hypotenuse normal (the first edge)
+    QPointF axes[3] = { QPointF(1, 0), QPointF(0, 1) };
+    int axisCount = 2;
+    if (n == 3) axes[axisCount++] = QPointF(poly[1].y() - poly[0].y(), poly[0].x() - poly[1].x());
+
+    const QRectF b = box.normalized();
+    const QPointF corners[4] = { b.topLeft(), b.topRight(), b.bottomRight(), b.bottomLeft() };
+    const double inf = std::numeric_limits<double>::infinity();
+    double enter = -inf, exit = inf;
+    QPointF enterNormal;
+    for (int a = 0; a < axisCount; ++a) {
+        const QPointF &axis = axes[a];
+        double slo, shi, blo, bhi;
+        project(poly, n, axis, &slo, &shi);
+        project(corners, 4, axis, &blo, &bhi);
+        const double v = QPointF::dotProduct(delta, axis);
+        double t0, t1;
+        if (bhi <= slo) {               // shape ahead along the axis
+            if (v <= 0.0) return false;
+            t0 = (slo - bhi) / v; t1 = (shi - blo) / v;
+            if (t0 > enter) { enter = t0; enterNormal = -axis; }
+        } else if (blo >= shi) {        // shape behind
+            if (v >= 0.0) return false;
+            t0 = (shi - blo) / v; t1 = (slo - bhi) / v;
+            if (t0 > enter) { enter = t0; enterNormal = axis; }
+        } else {                        // overlapping on this axis already
+            t1 = v > 0.0 ? (shi - blo) / v : (v < 0.0 ? (slo - bhi) / v : inf);
+        }
+        exit = qMin(exit, t1);
+    }
+    // enter stays -inf when every axis overlaps: started inside
+    if (enter < 0.0 || enter > 1.0 || enter >= exit) return false;
+
+    const double len = std::hypot(enterNormal.x(), enterNormal.y());
+    *toi = enter;
+    *normal = enterNormal / len;
+    return true;
+}
+
+}
+
+// ------------------------------
+// Quadratic paths
+// ------------------------------
+namespace Sweep {
+
+QRectF curveBounds(const QPointF &a, const QPointF &b, const QPointF &c, double t0, double t1) {
+    double lo[2], hi[2];
+    const double ax[2] = { a.x(), a.y() }, bx[2] = { b.x(), b.y() };
+    const QPointF p0 = at(a, b, c, t0), p1 = at(a, b, c, t1);
+    lo[0] = qMin(p0.x(), p1.x()); hi[0] = qMax(p0.x(), p1.x());
+    lo[1] = qMin(p0.y(), p1.y()); hi[1] = qMax(p0.y(), p1.y());
+    for (int k = 0; k < 2; ++k) {
+        if (ax[k] == 0.0) continue;
+        const double tv = -bx[k] / (2.0 * ax[k]);     // turning point
+        if (tv <= t0 || tv >= t1) continue;
+        const QPointF pv = at(a, b, c, tv);
+        const double v = k ? pv.y() : pv.x();
+        lo[k] = qMin(lo[k], v); hi[k] = qMax(hi[k], v);
+    }
+    return QRectF(QPointF(lo[0], lo[1]), QPointF(hi[0], hi[1]));
+}
+
+// The point is inside while it is on the inner side of every edge. Each
+// edge test along the path is a quadratic in t, so between its roots the
+// answer doesn't change: sort the roots and check once per stretch.
+bool curveShape(const QPointF &a, const QPointF &b, const QPointF &c, double t0, double t1,
+                const Shape &s, double *toi, QPointF *normal) {
+    QPointF poly[4];
+    const int n = outline(s, poly);
+    QPointF centroid;
+    for (int i = 0; i < n; ++i) centroid += poly[i] / n;
+
+    QPointF edge[4];            // outward, inside is dot(edge, p) < off
+    double off[4];
+    for (int i = 0; i < n; ++i) {
+        const QPointF &p = poly[i], &q = poly[(i + 1) % n];
+        QPointF e(q.y() - p.y(), p.x() - q.x());
+        if (QPointF::dotProduct(e, centroid - p) > 0.0) e = -e;
+        edge[i] = e;
+        off[i] = QPointF::dotProduct(e, p);
+    }
+    auto inside = [&](double t) {
+        const QPointF p = at(a, b, c, t);
+        for (int i = 0; i < n; ++i)
+            if (QPointF::dotProduct(edge[i], p) >= off[i]) return false;
+        return true;
+    };
+    if (inside(t0)) return false;   // started inside, as in shape()
+
+    double ts[2 * 4 + 2];
+    int m = 0;
+    ts[m++] = t0;
+    for (int i = 0; i < n; ++i) {
+        m += roots(QPointF::dotProduct(edge[i], a), QPointF::dotProduct(edge[i], b),
+                   QPointF::dotProduct(edge[i], c) - off[i], t0, t1, ts + m);
+    }
+    ts[m++] = t1;
+    const double t = firstStretch(ts, m, t1, inside);
+    if (t >= t1) return false;
+
+    // The edge it came through is the one it is on
+    const QPointF p = at(a, b, c, t);
+    int best = 0;
+    double bestDist = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < n; ++i) {
+        const double len = std::hypot(edge[i].x(), edge[i].y());
+        const double d = len > 0.0 ? qAbs(QPointF::dotProduct(edge[i], p) - off[i]) / len : bestDist;
+        if (d < bestDist) { bestDist = d; best = i; }
+    }
+    *toi = t;
+    *normal = edge[best] / std::hypot(edge[best].x(), edge[best].y());
+    return true;
+}
+
+Hit curve(const QPointF &a, const QPointF &b, const QPointF &c, double t0, double t1,
+          const QList<Shape> &shapes, const ShapeIndex &index) {
+    Hit best;
+    best.toi = t1;
+    ShapeIndex::Hits hits;
+    index.query(curveBounds(a, b, c, t0, t1), hits);
+    for (int i : hits) {
+        double toi; QPointF n;
+        if (!curveShape(a, b, c, t0, best.toi, shapes[i], &toi, &n)) continue;
+        best.shape = i; best.toi = toi; best.normal = n;
+    }
+    return best;
+}
+
+double leaveTime(const QRectF &rect, const QPointF &a, const QPointF &b, const QPointF &c, double t0, double t1) {
+    const QRectF r = rect.normalized();
+    auto outside = [&](double t) {
+        const QPointF p = at(a, b, c, t);
+        return p.x() < r.left() || p.x() > r.right() || p.y() < r.top() || p.y() > r.bottom();
+    };
+    if (outside(t0)) return t0;
+
+    double ts[2 * 4 + 2];
+    int m = 0;
+    ts[m++] = t0;
+    m += roots(a.x(), b.x(), c.x() - r.left(), t0, t1, ts + m);
+    m += roots(a.x(), b.x(), c.x() - r.right(), t0, t1, ts + m);
+    m += roots(a.y(), b.y(), c.y() - r.top(), t0, t1, ts + m);
+    m += roots(a.y(), b.y(), c.y() - r.bottom(), t0, t1, ts + m);
+    ts[m++] = t1;
+    return firstStretch(ts, m, t1, outside);
+}
+
+}
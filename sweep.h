@@ -0,0 +1,73 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <QList>
+#include <QPointF>
+#include <QRectF>
+
+#include "platform.h"
+#include "shapeindex.h"
+
+// ------------------------------
+// Continuous collision: a box (or a point) moving by delta over one step,
+// against Rect, TriLeft and TriRight shapes. Separating axes with times:
+// x, y and, for the slopes, the hypotenuse normal. toi is the fraction of
+// delta travelled at first contact, the normal points out of the shape.
+//
+// Shapes the box already overlaps at the start are not reported; resting
+// contact is left to the discrete response, these catch what a step skips.
+// Touching edges don't count, same as QRectF::intersects.
+// ------------------------------
+namespace Sweep {
+
+struct Hit {
+    int shape = -1;          // index into the shape list, -1 for a miss
+    double toi = 1.0;        // 0..1 along delta
+    QPointF normal;          // unit, out of the shape
+
+    bool isHit() const { return shape >= 0; }
+};
+
+bool shape(const QRectF &box, const QPointF &delta, const Shape &s, double *toi, QPointF *normal);
+
+// Swept bounds of a move, for the broadphase
+QRectF bounds(const QRectF &box, const QPointF &delta);
+
+// Earliest hit among the shapes the index finds along the move, skipping
+// those skip(index) rejects
+template<class Skip>
+Hit first(const QRectF &box, const QPointF &delta, const QList<Shape> &shapes, const ShapeIndex &index, Skip skip) {
+    Hit best;
+    ShapeIndex::Hits hits;
+    index.query(bounds(box, delta), hits);
+    for (int i : hits) {
+        double toi; QPointF n;
+        if (skip(i) || !shape(box, delta, shapes[i], &toi, &n) || toi >= best.toi) continue;
+        best.shape = i; best.toi = toi; best.normal = n;
+    }
+    return best;
+}
+
+inline Hit first(const QRectF &box, const QPointF &delta, const QList<Shape> &shapes, const ShapeIndex &index) {
+    return first(box, delta, shapes, index, [](int) { return false; });
+}
+
+inline Hit segment(const QPointF &from, const QPointF &to, const QList<Shape> &shapes, const ShapeIndex &index) {
+    return first(QRectF(from, from), to - from, shapes, index);
+}
+
+// A point on the path p(t) = a t^2 + b t + c (a quadratic Bézier in power
+// form), solved exactly over [t0, t1]. Here toi is t itself; a miss leaves
+// it at t1.
+QRectF curveBounds(const QPointF &a, const QPointF &b, const QPointF &c, double t0, double t1);
+bool curveShape(const QPointF &a, const QPointF &b, const QPointF &c, double t0, double t1,
+                const Shape &s, double *toi, QPointF *normal);
+Hit curve(const QPointF &a, const QPointF &b, const QPointF &c, double t0, double t1,
+          const QList<Shape> &shapes, const ShapeIndex &index);
+
+// First t in [t0, t1] with p(t) outside rect, t1 if it stays in
+double leaveTime(const QRectF &rect, const QPointF &a, const QPointF &b, const QPointF &c, double t0, double t1);
+
+}
+
+#endif // SWEEP_H
@@ -0,0 +1,64 @@
+#include <QHash>
+#include <QMutex>
+
+#include "arena.h"
+#include "symbol.h"
+
+namespace {
+
+struct Table {
+    QMutex mutex;
+    Arena text;
+    QHash<QStringView, quint32> ids;         // outside any scope
+    QHash<QStringView, quint32> scoped;      // the open scope's
+    QVector<QStringView> strings{ QStringView() };  // 0 is the empty string
+    int depth = 0;                           // of nested scopes
+    int scopeStart = 0;                      // first id of the outermost
+    Arena::Mark scopeMark;
+};
+
+Table &table() {
+    static Table t;
+    return t;
+}
+
+}
+
+Symbol Symbol::intern(QStringView s) {
+    if (s.isEmpty()) return Symbol();
+    Table &t = table();
+    QMutexLocker lock(&t.mutex);
+    auto it = t.ids.constFind(s);
+    if (it != t.ids.constEnd()) return Symbol(it.value());
+    it = t.scoped.constFind(s);
+    if (it != t.scoped.constEnd()) return Symbol(it.value());
+
+    const QStringView text = t.text.copy(s);
+    const quint32 id = quint32(t.strings.size());
+    t.strings << text;
+    (t.depth > 0 ? t.scoped : t.ids).insert(text, id);
+    return Symbol(id);
+}
+
+QString Symbol::toString() const {
+    Table &t = table();
+    QMutexLocker lock(&t.mutex);
+    return t.strings.value(int(m_id)).toString();
+}
+
+void Symbol::beginScope() {
+    Table &t = table();
+    QMutexLocker lock(&t.mutex);
+    if (t.depth++ > 0) return;
+    t.scopeStart = t.strings.size();
+    t.scopeMark = t.text.mark();
+}
+
+void Symbol::endScope() {
+    Table &t = table();
+    QMutexLocker lock(&t.mutex);
+    if (t.depth == 0 || --t.depth > 0) return;
+    t.scoped.clear();
+    t.strings.resize(t.scopeStart);
+    t.text.rewind(t.scopeMark);
+}
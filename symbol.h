@@ -0,0 +1,49 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <QHashFunctions>
+#include <QString>
+#include <QtGlobal>
+
+// ------------------------------
+// Interned string: a number standing for a string in one global table.
+// Level ids (36-character editor UUIDs) are interned once at load, after
+// that comparing, hashing and copying them is integer work. The text is
+// kept in the table for debug output and tools.
+//
+//   const Symbol id = Symbol::intern(u"3a840d33-...");
+//   id == other.id;              // integer compare
+//   qDebug() << id.toString();
+//
+// The text sits in one arena (see arena.h), not a QString per symbol.
+// Symbols interned between beginScope() and endScope() are dropped by
+// endScope() all at once, text included; Game scopes each level that way,
+// so a long session doesn't keep every level's ids. Scopes nest, and only
+// the outermost one's end drops anything. A Symbol must not be used after
+// its scope ends. Interning is thread safe.
+// ------------------------------
+class Symbol {
+public:
+    Symbol() = default;          // the empty string
+
+    static Symbol intern(QStringView s);
+    QString toString() const;
+
+    static void beginScope();
+    static void endScope();
+
+    quint32 id() const { return m_id; }
+    bool isNull() const { return m_id == 0; }
+
+    bool operator==(Symbol b) const { return m_id == b.m_id; }
+    bool operator!=(Symbol b) const { return m_id != b.m_id; }
+    bool operator<(Symbol b) const { return m_id < b.m_id; }   // table order, not text order
+
+private:
+    explicit Symbol(quint32 id) : m_id(id) {}
+    quint32 m_id = 0;
+};
+
+inline size_t qHash(Symbol s, size_t seed = 0) { return qHash(s.id(), seed); }
+
+#endif // SYMBOL_H
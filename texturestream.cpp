@@ -0,0 +1,214 @@
+#include <QOpenGLContext>
+#include <QMatrix4x4>
+#include <cstring>
+
+#include "texturestream.h"
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+
+TextureStream::~TextureStream() {
+    // GL objects need the context; Game calls cleanup() while it is current.
+    delete m_primeDevice;
+}
+
+void TextureStream::initialize() {
+    if (m_initialized) return;
+    initializeOpenGLFunctions();
+
+    // PBOs and glMapBufferRange need GL 3.0 / GLES 3.0; below that the stripes
+    // are uploaded straight from client memory, still under the frame budget.
+    const QSurfaceFormat fmt = QOpenGLContext::currentContext()->format();
+    m_usePbo = fmt.majorVersion() >= 3;
+    if (m_usePbo) glGenBuffers(kRing, m_pbo);
+
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_maxTextureSize);
+    m_blitter.create();
+    m_initialized = true;
+}
+
+void TextureStream::cleanup() {
+    if (!m_initialized) return;
+    clear();
+    if (m_usePbo) glDeleteBuffers(kRing, m_pbo);
+    for (int i = 0; i < kRing; ++i) { m_pbo[i] = 0; m_pboSize[i] = 0; }
+    m_blitter.destroy();
+    delete m_primeDevice; m_primeDevice = nullptr;
+    delete m_primeFbo; m_primeFbo = nullptr;
+    m_initialized = false;
+}
+
+void TextureStream::enqueue(const QImage &img) {
+    if (img.isNull() || m_entries.contains(img.cacheKey())) return;
+    if (img.width() > m_maxTextureSize || img.height() > m_maxTextureSize) return; // left to QPainter
+
+    Entry e;
+    e.img = img;
+    switch (img.format()) {
+    case QImage::Format_RGBA8888_Premultiplied:
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGB32:
+        break;
+    default: // rare: everything from Assets is already one of the above
+        e.img = img.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+        break;
+    }
+    m_entries.insert(img.cacheKey(), e);
+    m_pending.enqueue(img.cacheKey());
+}
+
+void TextureStream::prime(const QPixmap &px) {
+    if (!px.isNull()) m_primes.enqueue(px);
+}
+
+void TextureStream::pump(GLuint fbo) {
+    if (!m_initialized) return;
+    qint64 budget = kBudget;
+
+    while (budget > 0 && !m_pending.isEmpty()) {
+        auto it = m_entries.find(m_pending.head());
+        if (it == m_entries.end()) { m_pending.dequeue(); continue; }
+        Entry &e = it.value();
+
+        const qint64 rowBytes = qint64(e.img.width()) * 4;
+        const int rows = int(qBound<qint64>(1, budget / rowBytes, e.img.height() - e.nextRow));
+        uploadRows(e, rows);
+        budget -= rows * rowBytes;
+
+        if (e.nextRow >= e.img.height()) {
+            e.ready = true;
+            e.img = QImage(); // the caller keeps its own copy; ours is done
+            m_pending.dequeue();
+        }
+    }
+
+    bool primed = false;
+    while (budget > 0 && !m_primes.isEmpty()) {
+        const QPixmap px = m_primes.dequeue();
+        primeOne(px);
+        budget -= qint64(px.width()) * px.height() * 4;
+        primed = true;
+    }
+    if (primed) glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+}
+
+void TextureStream::uploadRows(Entry &e, int rows) {
+    const int w = e.img.width(), h = e.img.height();
+    if (!e.tex) {
+        glGenTextures(1, &e.tex);
+        glBindTexture(GL_TEXTURE_2D, e.tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, e.tex);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    const qint64 bytes = qint64(w) * rows * 4;
+    if (m_usePbo) {
+        // Next buffer in the ring; orphan it so the driver never stalls on a
+        // transfer that is still in flight from an earlier frame.
+        const int i = m_pboNext; m_pboNext = (m_pboNext + 1) % kRing;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[i]);
+        if (m_pboSize[i] < bytes) m_pboSize[i] = bytes;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, m_pboSize[i], nullptr, GL_STREAM_DRAW);
+        void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (dst) {
+            copyRowsRgba(static_cast<uchar *>(dst), e.img, e.nextRow, rows);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, e.nextRow, w, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (!dst) { m_usePbo = false; uploadRows(e, rows); return; } // mapping unsupported after all
+    } else {
+        if (m_staging.size() < bytes) m_staging.resize(bytes);
+        copyRowsRgba(reinterpret_cast<uchar *>(m_staging.data()), e.img, e.nextRow, rows);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, e.nextRow, w, rows, GL_RGBA, GL_UNSIGNED_BYTE, m_staging.constData());
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    e.nextRow += rows;
+    Q_ASSERT(e.nextRow <= h);
+}
+
+// Tightly packed RGBA bytes, which is what GL_RGBA/GL_UNSIGNED_BYTE wants.
+// ARGB32 is a native-endian 0xAARRGGBB word, so this is a per-pixel swizzle.
+void TextureStream::copyRowsRgba(uchar *dst, const QImage &src, int row, int rows) {
+    const int w = src.width();
+    if (src.format() == QImage::Format_RGBA8888_Premultiplied) {
+        for (int y = 0; y < rows; ++y)
+            std::memcpy(dst + qint64(y) * w * 4, src.constScanLine(row + y), size_t(w) * 4);
+        return;
+    }
+    const quint32 alpha = src.format() == QImage::Format_RGB32 ? 0xff000000u : 0u;
+    for (int y = 0; y < rows; ++y) {
+        const quint32 *s = reinterpret_cast<const quint32 *>(src.constScanLine(row + y));
+        uchar *d = dst + qint64(y) * w * 4;
+        for (int x = 0; x < w; ++x) {
+            const quint32 p = s[x] | alpha;
+            d[4*x + 0] = uchar(p >> 16);
+            d[4*x + 1] = uchar(p >> 8);
+            d[4*x + 2] = uchar(p);
+            d[4*x + 3] = uchar(p >> 24);
+        }
+    }
+}
+
+void TextureStream::primeOne(const QPixmap &px) {
+    if (!m_primeFbo) {
+        m_primeFbo = new QOpenGLFramebufferObject(4, 4);
+        m_primeDevice = new QOpenGLPaintDevice(m_primeFbo->size());
+    }
+    if (!m_primeFbo->bind()) return;
+    QPainter p(m_primeDevice);
+    p.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    p.drawPixmap(QRect(0, 0, 4, 4), px);
+}
+
+bool TextureStream::draw(QPainter &p, const QImage &img, const QRectF &target) {
+    auto it = m_entries.constFind(img.cacheKey());
+    if (it == m_entries.constEnd()) return false;
+    if (!it->ready) return true;
+
+    // Blitter quad is [-1,1]^2 with +y up; map it onto target (top-left first),
+    // through the painter's transform, then into normalized device coordinates.
+    QMatrix4x4 quad;
+    quad.translate(target.left(), target.top());
+    quad.scale(target.width() / 2.0, -target.height() / 2.0);
+    quad.translate(1.0, -1.0);
+
+    QMatrix4x4 proj;
+    proj.ortho(0, p.device()->width(), p.device()->height(), 0, -1, 1);
+
+    const QMatrix4x4 m = proj * QMatrix4x4(p.combinedTransform()) * quad;
+
+    p.beginNativePainting();
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // premultiplied
+    m_blitter.bind();
+    m_blitter.setOpacity(p.opacity());
+    m_blitter.blit(it->tex, m, QOpenGLTextureBlitter::OriginTopLeft);
+    m_blitter.release();
+    p.endNativePainting();
+    return true;
+}
+
+void TextureStream::clear() {
+    for (auto &e : m_entries) if (e.tex) glDeleteTextures(1, &e.tex);
+    m_entries.clear();
+    m_pending.clear();
+    m_primes.clear();
+}
@@ -0,0 +1,85 @@
+#ifndef TEXTURESTREAM_H
+#define TEXTURESTREAM_H
+
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLTextureBlitter>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLPaintDevice>
+#include <QPainter>
+#include <QImage>
+#include <QPixmap>
+#include <QHash>
+#include <QQueue>
+
+// ------------------------------
+// Streams level art to the GPU a few stripes per frame instead of letting the
+// paint engine upload a whole 3000x2000 background inside the frame it first
+// shows up in.
+//
+// Large images (level graphics, parallax layers) are copied through a ring of
+// pixel buffer objects into our own textures and blitted from native painting.
+// A texture only becomes drawable when its last stripe is in. Sprites that
+// stay with QPainter (fighters, the rig) can be primed: they are drawn once
+// into a tiny offscreen target so the paint engine's texture cache has them
+// before their first real frame. Both share one per-frame byte budget.
+// ------------------------------
+class TextureStream : protected QOpenGLExtraFunctions {
+public:
+    TextureStream() = default;
+    ~TextureStream();
+
+    // With the context current (initializeGL / before it goes away)
+    void initialize();
+    void cleanup();
+
+    // Queue an image for streaming; keyed by QImage::cacheKey().
+    void enqueue(const QImage &img);
+    // Queue a pixmap for priming the paint engine's texture cache.
+    void prime(const QPixmap &px);
+
+    // Upload up to the frame budget. Call at the start of paintGL, before the
+    // widget painter exists; fbo is the widget's framebuffer to rebind after.
+    void pump(GLuint fbo);
+
+    // Draw img into target (painter logical coordinates). Returns false when
+    // the image is not handled by the stream and the caller should draw it
+    // with QPainter; images still streaming are skipped and return true.
+    bool draw(QPainter &p, const QImage &img, const QRectF &target);
+
+    // Drop every texture and pending upload (level change)
+    void clear();
+
+private:
+    struct Entry {
+        GLuint tex = 0;
+        QImage img;        // source, dropped once uploaded
+        int nextRow = 0;   // rows uploaded so far
+        bool ready = false;
+    };
+
+    void uploadRows(Entry &e, int rows);
+    void primeOne(const QPixmap &px);
+    static void copyRowsRgba(uchar *dst, const QImage &src, int row, int rows);
+
+    bool m_initialized = false;
+    bool m_usePbo = false;
+    GLint m_maxTextureSize = 2048;
+
+    static const int kRing = 3;
+    GLuint m_pbo[kRing] = {0, 0, 0};
+    qint64 m_pboSize[kRing] = {0, 0, 0};
+    int m_pboNext = 0;
+    QByteArray m_staging; // client-memory fallback without PBOs
+
+    static const qint64 kBudget = 4 * 1024 * 1024; // bytes per frame
+
+    QHash<qint64, Entry> m_entries;
+    QQueue<qint64> m_pending;
+    QQueue<QPixmap> m_primes;
+
+    QOpenGLTextureBlitter m_blitter;
+    QOpenGLFramebufferObject *m_primeFbo = nullptr;
+    QOpenGLPaintDevice *m_primeDevice = nullptr;
+};
+
+#endif // TEXTURESTREAM_H
@@ -0,0 +1,26 @@
+# PellsBawl's clip tables (pellsBawlAnim.h), generated at build time from
+# assets/pb/pellsBawl.anim.json by tools/animc, built here for the host. The
+# header lands in OUT_PWD and is regenerated whenever the JSON, anim.h or
+# animc changes; it is not kept in the source tree.
+ANIMC_DIR = $$OUT_PWD/tools/animc
+win32: ANIMC = $$ANIMC_DIR/animc.exe
+else: ANIMC = $$ANIMC_DIR/animc
+
+animc.target = $$ANIMC
+animc.depends = $$PWD/main.cpp $$PWD/animc.pro
+animc.commands = $$sprintf($$QMAKE_MKDIR_CMD, $$shell_path($$ANIMC_DIR)) $$escape_expand(\n\t) \
+    cd $$shell_path($$ANIMC_DIR) && $$shell_path($$QMAKE_QMAKE) CONFIG-=debug_and_release $$shell_path($$PWD/animc.pro) && $(MAKE)
+QMAKE_EXTRA_TARGETS += animc
+
+# An extra compiler rather than a target, so qmake knows the objects that
+# include the header depend on it
+ANIM_JSON = $$PWD/../../assets/pb/pellsBawl.anim.json
+animc_header.input = ANIM_JSON
+animc_header.output = $$OUT_PWD/pellsBawlAnim.h
+animc_header.depends = $$ANIMC $$PWD/../../anim.h
+animc_header.commands = $$shell_path($$ANIMC) -o ${QMAKE_FILE_OUT} ${QMAKE_FILE_IN}
+animc_header.variable_out = HEADERS
+animc_header.CONFIG += no_link target_predeps
+QMAKE_EXTRA_COMPILERS += animc_header
+
+INCLUDEPATH += $$OUT_PWD $$PWD/../..
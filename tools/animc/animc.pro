@@ -0,0 +1,10 @@
+# Compiles rig animation JSON into constexpr clip tables (see anim.h).
+#   qmake tools/animc && make && ./animc -o pellsBawlAnim.h assets/pb/pellsBawl.anim.json
+# platformer.pro and curvebench build and run it through animc.pri.
+TEMPLATE = app
+TARGET = animc
+QT = core
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SOURCES = main.cpp
@@ -0,0 +1,239 @@
+// animc — compiles rig animation JSON into a header of constexpr tables
+// (types in anim.h). Builds run it through animc.pri, which regenerates the
+// header whenever the JSON changes; by hand:
+//
+//   animc [-n <namespace>] [-o <out.h>] <anim.json>
+//
+// Part ids become a Role enum and clip ids a ClipId enum (CamelCase). Track
+// defaults from "parts" and "defaults" are folded in, curves are resolved and
+// every clip's tracks are stored body first, then stable sorted by zOrder,
+// which is the order paintWalker draws them in.
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSizeF>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+
+static QTextStream out(stdout);
+
+struct Track {
+    int role = 0;
+    QString id;
+    double w = 0, h = 0, baseX = 0, baseY = 0;
+    QString x, y, rot;       // curve initializers
+    int zOrder = 1;
+};
+
+struct Clip {
+    QString id, name;
+    double durationSec = 1.0;
+    bool loop = true, useFootCapsule = false;
+    QVector<Track> tracks;
+    int body = -1;
+};
+
+static QString num(double v) { return QString::number(v, 'g', QLocale::FloatingPointShortest); }
+
+// "left_foot" -> "LeftFoot"
+static QString camel(const QString &id) {
+    QString s;
+    bool up = true;
+    for (const QChar c : id) {
+        if (!c.isLetterOrNumber()) { up = true; continue; }
+        s += up ? c.toUpper() : c;
+        up = false;
+    }
+    if (s.isEmpty() || s.at(0).isDigit()) s.prepend('_');
+    return s;
+}
+
+// Same rules as the old runtime loader: bare numbers are const, unknown
+// types and missing channels are const 0
+static QString curve(const QJsonValue &v) {
+    if (!v.isObject()) return QString("Anim::constant(%1)").arg(num(v.toDouble(0.0)));
+    const QJsonObject o = v.toObject();
+    const QString t = o.value("type").toString("const");
+    if (t == "sine")
+        return QString("Anim::sine(%1, %2, %3)").arg(num(o.value("amp").toDouble(0.0)), num(o.value("phaseDeg").toDouble(0.0)),
+                                                      num(o.value("bias").toDouble(0.0)));
+    if (t == "linear") {
+        const double start = o.value("start").toDouble(0.0);
+        return QString("Anim::linear(%1, %2)").arg(num(start), num(o.value("end").toDouble(start)));
+    }
+    if (t != "const") out << "warning: unknown curve type " << t << ", using const 0\n";
+    return QString("Anim::constant(%1)").arg(num(t == "const" ? o.value("value").toDouble(0.0) : 0.0));
+}
+
+static QSizeF readSize(const QJsonValue &v) {
+    if (v.isDouble()) return QSizeF(v.toDouble(), v.toDouble());
+    const QJsonObject o = v.toObject();
+    if (o.contains("w") && o.contains("h")) return QSizeF(o.value("w").toDouble(), o.value("h").toDouble());
+    return QSizeF();
+}
+
+static bool compile(const QString &in, const QString &outPath, const QString &ns) {
+    QFile f(in);
+    if (!f.open(QIODevice::ReadOnly)) { out << "can't read " << in << "\n"; return false; }
+    QJsonParseError pe;
+    const QJsonObject root = QJsonDocument::fromJson(f.readAll(), &pe).object();
+    if (pe.error != QJsonParseError::NoError) { out << in << ": " << pe.errorString() << "\n"; return false; }
+
+    const QJsonObject meta = root.value("meta").toObject();
+    QStringList roles;       // part ids, first seen first
+    auto role = [&roles](const QString &id) {
+        if (!roles.contains(id)) roles << id;
+        return int(roles.indexOf(id));
+    };
+
+    QHash<QString, QSizeF> sizeDefaults;
+    for (const auto &pv : root.value("parts").toArray()) {
+        const QJsonObject po = pv.toObject();
+        const QString id = po.value("id").toString();
+        if (id.isEmpty()) continue;
+        role(id);
+        const QSizeF sz = readSize(po.value("size"));
+        if (sz.isValid() && !sz.isEmpty()) sizeDefaults.insert(id, sz);
+    }
+    const QJsonObject defs = root.value("defaults").toObject();
+    const QJsonObject baseDefaults = defs.value("baseOffsets").toObject();
+    const QJsonObject zDefaults = defs.value("zOrder").toObject();
+
+    QVector<Clip> clips;
+    for (const auto &av : root.value("animations").toArray()) {
+        const QJsonObject ao = av.toObject();
+        Clip clip;
+        clip.id = ao.value("id").toString();
+        if (clip.id.isEmpty()) continue;
+        clip.name = camel(clip.id);
+        clip.durationSec = ao.value("durationSec").toDouble(1.0);
+        clip.loop = ao.value("loop").toBool(true);
+        clip.useFootCapsule = ao.value("useFootCapsule").toBool(false);
+
+        for (const auto &tv : ao.value("tracks").toArray()) {
+            const QJsonObject to = tv.toObject();
+            Track tr;
+            tr.id = to.value("id").toString();
+            if (tr.id.isEmpty()) continue;
+            tr.role = role(tr.id);
+
+            QSizeF sz = readSize(to.value("size"));
+            if (!sz.isValid() || sz.isEmpty()) sz = sizeDefaults.value(tr.id);
+            if (sz.isValid() && !sz.isEmpty()) { tr.w = sz.width(); tr.h = sz.height(); }
+
+            const QJsonObject bo = to.contains("baseOffset") ? to.value("baseOffset").toObject()
+                                                              : baseDefaults.value(tr.id).toObject();
+            tr.baseX = bo.value("x").toDouble(0.0);
+            tr.baseY = bo.value("y").toDouble(0.0);
+            tr.zOrder = to.value("zOrder").toInt(zDefaults.value(tr.id).toInt(1));
+
+            const QJsonObject props = to.value("properties").toObject();
+            tr.x = curve(props.value("x"));
+            tr.y = curve(props.value("y"));
+            tr.rot = curve(props.value("rotationDeg"));
+
+            // Only the first body track drives the rig, like trackById("body") did
+            if (tr.id == "body") {
+                if (clip.body >= 0) continue;
+                clip.body = 0;
+                clip.tracks.prepend(tr);
+            } else {
+                clip.tracks << tr;
+            }
+        }
+        std::stable_sort(clip.tracks.begin(), clip.tracks.end(),
+                         [](const Track &a, const Track &b) { return a.zOrder < b.zOrder; });
+        for (int i = 0; i < clip.tracks.size(); ++i)
+            if (clip.tracks[i].id == "body") clip.body = i;
+        clips << clip;
+    }
+    if (clips.isEmpty()) { out << in << ": no animations\n"; return false; }
+
+    // Both enums live in one namespace
+    QStringList names;
+    for (const QString &r : roles) names << camel(r);
+    for (const Clip &c : clips) names << c.name;
+    for (const QString &n : names)
+        if (names.count(n) > 1) { out << in << ": id " << n << " is not unique as an enumerator\n"; return false; }
+
+    QString defaultClip = meta.value("defaultClip").toString();
+    auto def = std::find_if(clips.cbegin(), clips.cend(), [&](const Clip &c) { return c.id == defaultClip; });
+    if (def == clips.cend()) def = clips.cbegin();
+
+    int maxTracks = 0;
+    for (const Clip &c : clips) maxTracks = qMax(maxTracks, int(c.tracks.size()));
+
+    QString h;
+    QTextStream s(&h);
+    const QString guard = ns.toUpper() + "_H";
+    s << "// Generated by tools/animc from " << QFileInfo(in).fileName() << " at build time. Do not edit.\n"
+      << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+      << "#include \"anim.h\"\n\n"
+      << "namespace " << ns << " {\n\n";
+
+    s << "enum Role : quint8 {";
+    for (int i = 0; i < roles.size(); ++i) s << (i ? ", " : " ") << camel(roles[i]);
+    s << ", RoleCount };\n";
+    s << "constexpr const char *kRoleIds[RoleCount] = {";
+    for (int i = 0; i < roles.size(); ++i) s << (i ? ", " : " ") << '"' << roles[i] << '"';
+    s << " };\n\n";
+
+    s << "enum ClipId : quint8 {";
+    for (int i = 0; i < clips.size(); ++i) s << (i ? ", " : " ") << clips[i].name;
+    s << ", ClipCount };\n";
+    s << "constexpr ClipId kDefaultClip = " << def->name << ";\n"
+      << "constexpr double kGlobalScale = " << num(meta.value("globalScale").toDouble(1.0)) << ";\n"
+      << "constexpr int kMaxTracks = " << maxTracks << ";\n\n";
+
+    s << "// role, motion, footPhase, w, h, baseX, baseY, x, y, rotationDeg, zOrder\n";
+    for (const Clip &c : clips) {
+        s << "constexpr Anim::TrackDef k" << c.name << "Tracks[] = {\n";
+        for (const Track &tr : c.tracks) {
+            const bool foot = tr.id != "body" && tr.id.contains("foot");
+            const QString motion = tr.id == "body" ? "Anim::Body" : foot ? "Anim::Foot" : "Anim::Part";
+            s << "    { " << camel(tr.id) << ", " << motion << ", " << (foot && !tr.id.contains("left") ? "0.5" : "0") << ", "
+              << num(tr.w) << ", " << num(tr.h) << ", " << num(tr.baseX) << ", " << num(tr.baseY) << ",\n"
+              << "      " << tr.x << ", " << tr.y << ", " << tr.rot << ", " << tr.zOrder << " },\n";
+        }
+        s << "};\n";
+    }
+    s << "\nconstexpr Anim::ClipDef kClips[ClipCount] = {\n";
+    for (const Clip &c : clips)
+        s << "    { \"" << c.id << "\", " << num(c.durationSec) << ", " << (c.loop ? "true" : "false") << ", "
+          << (c.useFootCapsule ? "true" : "false") << ", k" << c.name << "Tracks, " << c.tracks.size() << ", " << c.body << " },\n";
+    s << "};\n\n}\n\n#endif // " << guard << "\n";
+    s.flush();
+
+    QFile o(outPath);
+    if (!o.open(QIODevice::WriteOnly | QIODevice::Text) || o.write(h.toUtf8()) < 0) { out << "can't write " << outPath << "\n"; return false; }
+    out << in << " -> " << outPath << ": " << roles.size() << " parts, " << clips.size() << " clips\n";
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments().mid(1);
+    QString outPath, ns;
+    QStringList inputs;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "-o" && i + 1 < args.size()) outPath = args[++i];
+        else if (args[i] == "-n" && i + 1 < args.size()) ns = args[++i];
+        else inputs << args[i];
+    }
+    if (inputs.size() != 1) {
+        out << "usage: animc [-n <namespace>] [-o <out.h>] <anim.json>\n";
+        return 1;
+    }
+
+    // pellsBawl.anim.json -> namespace PellsBawlAnim, pellsBawlAnim.h
+    if (ns.isEmpty()) ns = camel(QFileInfo(inputs[0]).completeBaseName());
+    if (outPath.isEmpty()) outPath = ns.left(1).toLower() + ns.mid(1) + ".h";
+    return compile(inputs[0], outPath, ns) ? 0 : 1;
+}
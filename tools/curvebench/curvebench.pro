@@ -0,0 +1,17 @@
+# Scalar Curve::eval against CurveBatch over a crowd of PellsBawl rigs.
+#   qmake tools/curvebench && make && ./curvebench [--rigs N] [--frames N]
+TEMPLATE = app
+TARGET = curvebench
+QT = core
+CONFIG += console c++17 release
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES = main.cpp \
+    ../../curvebatch.cpp
+HEADERS = \
+    ../../anim.h \
+    ../../curvebatch.h
+
+include(../animc/animc.pri)
@@ -0,0 +1,88 @@
+// curvebench — per-frame curve evaluation for a crowd of rigs, scalar
+// Curve::eval (what paintWalker does per track) against CurveBatch.
+//
+//   curvebench [--rigs <n>] [--frames <n>]
+//
+// Rigs cycle through the PellsBawl clips at staggered times. Prints the time
+// per frame and per channel for both, and the largest difference between
+// them over the run.
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include <cmath>
+
+#include "curvebatch.h"
+#include "pellsBawlAnim.h"
+
+static QTextStream out(stdout);
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments().mid(1);
+    int rigs = 500, frames = 2000;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--rigs" && i + 1 < args.size()) rigs = qMax(1, args[++i].toInt());
+        else if (args[i] == "--frames" && i + 1 < args.size()) frames = qMax(1, args[++i].toInt());
+        else { out << "usage: curvebench [--rigs <n>] [--frames <n>]\n"; return 1; }
+    }
+
+    QVector<const Anim::ClipDef *> clips;
+    QVector<double> offset;
+    CurveBatch batch;
+    for (int i = 0; i < rigs; ++i) {
+        clips << &PellsBawlAnim::kClips[i % PellsBawlAnim::ClipCount];
+        offset << i * 0.037;
+        batch.addRig(clips.back());
+    }
+    batch.evaluate(); // packs the columns, so channelCount() is known
+
+    auto timeAt = [&](int rig, int frame) {
+        return std::fmod(frame / 60.0 + offset[rig], clips[rig]->durationSec);
+    };
+
+    // Scalar: three evals per track, like paintWalker
+    QVector<double> scalar(batch.channelCount());
+    double sink = 0.0;
+    QElapsedTimer timer; timer.start();
+    for (int f = 0; f < frames; ++f) {
+        int k = 0;
+        for (int r = 0; r < rigs; ++r) {
+            const Anim::ClipDef &c = *clips[r];
+            const double t = timeAt(r, f);
+            for (int i = 0; i < c.trackCount; ++i) {
+                const Anim::TrackDef &tr = c.tracks[i];
+                scalar[k++] = tr.x.eval(t, c.durationSec);
+                scalar[k++] = tr.y.eval(t, c.durationSec);
+                scalar[k++] = tr.rot.eval(t, c.durationSec);
+            }
+        }
+        sink += scalar[f % scalar.size()];
+    }
+    const qint64 scalarNs = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int f = 0; f < frames; ++f) {
+        for (int r = 0; r < rigs; ++r) batch.setTime(r, timeAt(r, f));
+        batch.evaluate();
+        sink += batch.value(f % rigs, 0, CurveBatch::Y);
+    }
+    const qint64 batchNs = timer.nsecsElapsed();
+
+    // Accuracy on the last frame
+    double maxErr = 0.0;
+    for (int r = 0, k = 0; r < rigs; ++r)
+        for (int i = 0; i < clips[r]->trackCount; ++i)
+            for (int ch = 0; ch < CurveBatch::ChannelCount; ++ch, ++k)
+                maxErr = qMax(maxErr, std::fabs(batch.value(r, i, CurveBatch::Channel(ch)) - scalar[k]));
+
+    const double channels = double(batch.channelCount()) * frames;
+    out << rigs << " rigs, " << batch.channelCount() << " channels, " << frames << " frames\n"
+        << QString("  scalar %1 us/frame  %2 ns/channel\n").arg(scalarNs / 1e3 / frames, 0, 'f', 1).arg(scalarNs / channels, 0, 'f', 2)
+        << QString("  batch  %1 us/frame  %2 ns/channel  x%3\n").arg(batchNs / 1e3 / frames, 0, 'f', 1)
+                                                               .arg(batchNs / channels, 0, 'f', 2)
+                                                               .arg(double(scalarNs) / qMax<qint64>(1, batchNs), 0, 'f', 2)
+        << QString("  max |batch - scalar| %1  (checksum %2)\n").arg(maxErr, 0, 'g', 3).arg(sink, 0, 'g', 6);
+    return 0;
+}
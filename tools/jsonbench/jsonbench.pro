@@ -0,0 +1,21 @@
+# Times level JSON loading: QJsonDocument DOM against the streaming reader.
+#   qmake tools/jsonbench && make && ./jsonbench [--shapes N] [--runs N] [level.json...]
+TEMPLATE = app
+TARGET = jsonbench
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES = main.cpp \
+    ../../arena.cpp \
+    ../../jsonreader.cpp \
+    ../../levelreader.cpp \
+    ../../symbol.cpp
+HEADERS = \
+    ../../arena.h \
+    ../../jsonreader.h \
+    ../../levelreader.h \
+    ../../platform.h \
+    ../../symbol.h
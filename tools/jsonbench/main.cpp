@@ -0,0 +1,169 @@
+// jsonbench — level JSON load time, QJsonDocument DOM against readLevel().
+//
+//   jsonbench [--shapes <n>] [--runs <n>] [level.json...]
+//
+// Without files it generates a synthetic level with n interaction shapes (and
+// n/4 areas, n/2 graphics, 8 parallax layers). The DOM path is the loader
+// Game used before levelreader.cpp, minus the image decoding; both fill the
+// same structures so the numbers compare parsing and extraction only.
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <algorithm>
+
+#include "levelreader.h"
+
+static QTextStream out(stdout);
+
+// ------------------------------
+// Old DOM loader
+// ------------------------------
+static QPointF jsonToPoint(const QJsonValue& v){ QJsonObject o=v.toObject(); return QPointF(o.value("x").toDouble(), o.value("y").toDouble()); }
+static QRectF jsonToRect(const QJsonValue& v){ QJsonObject o=v.toObject(); return QRectF(o.value("x").toDouble(), o.value("y").toDouble(), o.value("w").toDouble(), o.value("h").toDouble()); }
+
+static bool readLevelDom(const QByteArray &json, LevelData &level) {
+    QJsonParseError pe;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &pe);
+    if (pe.error != QJsonParseError::NoError) return false;
+    const QJsonObject root = doc.object();
+
+    level.basePath = root.value("basePath").toString(":assets/");
+    level.world = jsonToRect(root.value("world"));
+    level.window = jsonToRect(root.value("window"));
+    for (auto v : root.value("interaction").toArray()){
+        QJsonObject o=v.toObject();
+        Shape it; it.id = Symbol::intern(o.value("id").toString("dummy"));
+        it.shape = o.value("shape").toString("rect") == "rect" ? Shape::Rect : (o.value("shape").toString() == "tri_left" ? Shape::TriLeft : Shape::TriRight);
+        it.isWall = o.value("is_wall").toBool(false);
+        it.rect = jsonToRect(o.value("rect"));
+        level.shapes.push_back(it);
+    }
+    for (auto v : root.value("areas").toArray()){
+        QJsonObject o=v.toObject();
+        Area ar; ar.id = Symbol::intern(o.value("id").toString("dummy"));
+        ar.title = o.value("title").toString("øf");
+        ar.rect = jsonToRect(o.value("rect"));
+        level.areas.push_back(ar);
+    }
+    for (auto v : root.value("graphics").toArray()){
+        QJsonObject o = v.toObject();
+        Image s; s.id = Symbol::intern(o.value("id").toString());
+        s.path = Symbol::intern(o.value("path").toString());
+        s.z = o.value("z").toDouble(0);
+        s.tf.pos = jsonToPoint(o.value("pos"));
+        s.tf.rotation=o.value("rotation").toDouble(0);
+        s.tf.scaleX=o.value("scaleX").toDouble(1.0);
+        s.tf.scaleY=o.value("scaleY").toDouble(1.0);
+        level.images.push_back(s);
+    }
+    for (auto l : root.value("parallax").toArray()) {
+        QJsonObject o = l.toObject();
+        LevelParallax g;
+        g.image = o.value("image").toString();
+        const QJsonArray off = o.value("off").toArray(), rate = o.value("rate").toArray();
+        g.off = QPointF(off.at(0).toDouble(), off.at(1).toDouble());
+        g.rate = QPointF(rate.at(0).toDouble(), rate.at(1).toDouble());
+        g.scale = o.value("scale").toDouble();
+        g.z = o.value("z").toInt();
+        g.wrap = o.value("wrap").toBool();
+        level.parallax.push_back(g);
+    }
+    level.bounds = level.world;
+    return true;
+}
+
+// ------------------------------
+// Synthetic level, same schema the editor writes
+// ------------------------------
+static QByteArray makeLevel(int shapes) {
+    QRandomGenerator rng(42);
+    auto rect = [&rng]() {
+        QJsonObject o;
+        o["x"] = rng.bounded(20000.0); o["y"] = rng.bounded(4000.0);
+        o["w"] = 20 + rng.bounded(600.0); o["h"] = 20 + rng.bounded(200.0);
+        return o;
+    };
+    static const char *kinds[] = { "rect", "tri_left", "tri_right" };
+
+    QJsonObject root;
+    root["basePath"] = ":assets/";
+    root["world"] = QJsonObject{{"x", 0}, {"y", 0}, {"w", 20000}, {"h", 4000}};
+    root["window"] = QJsonObject{{"x", 0}, {"y", 0}, {"w", 1920}, {"h", 1080}};
+    QJsonArray interaction, areas, graphics, parallax;
+    for (int i = 0; i < shapes; ++i)
+        interaction.append(QJsonObject{{"id", QString("shape_%1").arg(i)}, {"shape", kinds[i % 3]},
+                                       {"is_wall", i % 7 == 0}, {"rect", rect()}});
+    for (int i = 0; i < shapes / 4; ++i)
+        areas.append(QJsonObject{{"id", QString("area_%1").arg(i)}, {"title", QString("Area %1").arg(i)}, {"rect", rect()}});
+    for (int i = 0; i < shapes / 2; ++i)
+        graphics.append(QJsonObject{{"id", QString("gfx_%1").arg(i)}, {"path", QString("/home/editor/art/tile_%1.png").arg(i % 64)},
+                                    {"z", rng.bounded(10)}, {"pos", QJsonObject{{"x", rng.bounded(20000.0)}, {"y", rng.bounded(4000.0)}}},
+                                    {"rotation", rng.bounded(360.0)}, {"scaleX", 0.5 + rng.bounded(1.0)}, {"scaleY", 0.5 + rng.bounded(1.0)}});
+    for (int i = 0; i < 8; ++i)
+        parallax.append(QJsonObject{{"image", QString("layer%1.png").arg(i)}, {"off", QJsonArray{0, 100 * i}},
+                                    {"rate", QJsonArray{0.1 * i, 0.05 * i}}, {"scale", 1.0}, {"z", -i}, {"wrap", true}});
+    root["interaction"] = interaction;
+    root["areas"] = areas;
+    root["graphics"] = graphics;
+    root["parallax"] = parallax;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+// Median wall time of runs, in milliseconds
+template<class F> static double timeMs(int runs, F &&load) {
+    QList<double> t;
+    for (int i = 0; i < runs; ++i) {
+        QElapsedTimer timer; timer.start();
+        load();
+        t << timer.nsecsElapsed() / 1e6;
+    }
+    std::sort(t.begin(), t.end());
+    return t.at(t.size() / 2);
+}
+
+static void bench(const QString &name, const QByteArray &json, int runs) {
+    LevelData dom, stream;
+    if (!readLevelDom(json, dom) || !readLevel(json, stream)) { out << name << ": parse error\n"; return; }
+    if (dom.shapes.size() != stream.shapes.size() || dom.areas.size() != stream.areas.size()
+        || dom.images.size() != stream.images.size() || dom.parallax.size() != stream.parallax.size())
+        out << name << ": readers disagree\n";
+
+    const double domMs = timeMs(runs, [&] { LevelData l; readLevelDom(json, l); });
+    const double streamMs = timeMs(runs, [&] { LevelData l; readLevel(json, l); });
+    const double mb = json.size() / (1024.0 * 1024.0);
+    out << name << ": " << json.size() / 1024 << " KiB, " << stream.shapes.size() << " shapes\n"
+        << QString("  dom    %1 ms  (%2 MiB/s)\n").arg(domMs, 0, 'f', 2).arg(mb / domMs * 1000, 0, 'f', 1)
+        << QString("  stream %1 ms  (%2 MiB/s)  x%3\n").arg(streamMs, 0, 'f', 2).arg(mb / streamMs * 1000, 0, 'f', 1)
+                                                     .arg(domMs / streamMs, 0, 'f', 2);
+    out.flush();
+}
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments().mid(1);
+    int shapes = 20000, runs = 15;
+    QStringList files;
+    while (!args.isEmpty()) {
+        const QString a = args.takeFirst();
+        if (a == "--shapes" && !args.isEmpty()) shapes = args.takeFirst().toInt();
+        else if (a == "--runs" && !args.isEmpty()) runs = qMax(1, args.takeFirst().toInt());
+        else files << a;
+    }
+
+    if (files.isEmpty()) {
+        bench(QString("synthetic"), makeLevel(shapes), runs);
+        return 0;
+    }
+    for (const QString &fn : files) {
+        QFile f(fn);
+        if (!f.open(QIODevice::ReadOnly)) { out << "can't read " << fn << "\n"; continue; }
+        bench(fn, f.readAll(), runs);
+    }
+    return 0;
+}
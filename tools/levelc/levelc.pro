@@ -0,0 +1,13 @@
+# Compiles level JSON into the binary .pbl format (see levelformat.h).
+#   qmake tools/levelc && make && ./levelc assets/level1/level1_wportal.json
+# platformer.pro builds it and recompiles a shipped level whenever its JSON changes.
+TEMPLATE = app
+TARGET = levelc
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES = main.cpp
+HEADERS = ../../levelformat.h
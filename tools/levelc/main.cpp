@@ -0,0 +1,211 @@
+// levelc — compiles level JSON into a .pbl next to it (see levelformat.h).
+//
+//   levelc [--cell <size>] [-o <out.pbl>] <level.json>...
+//
+// Only the current level schema ("interaction", "areas", "enemies",
+// "graphics", "parallax"); legacy "platforms" levels are left to the JSON loader.
+// platformer.pro runs it for every shipped level and puts the .pbl under
+// levels/ next to the game, which maps it in place.
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QVector>
+#include <cmath>
+
+#include "levelformat.h"
+
+using namespace LevelFormat;
+
+static QTextStream out(stdout);
+
+static QRectF jsonToRect(const QJsonValue &v) {
+    const QJsonObject o = v.toObject();
+    return QRectF(o.value("x").toDouble(), o.value("y").toDouble(), o.value("w").toDouble(), o.value("h").toDouble());
+}
+
+class Strings {
+public:
+    quint32 intern(const QString &s) {
+        auto it = m_index.constFind(s);
+        if (it != m_index.constEnd()) return it.value();
+        const quint32 i = quint32(m_strings.size());
+        m_strings << s.toUtf8();
+        m_index.insert(s, i);
+        return i;
+    }
+    const QList<QByteArray> &all() const { return m_strings; }
+private:
+    QHash<QString, quint32> m_index;
+    QList<QByteArray> m_strings;
+};
+
+template<class T> static Section append(QByteArray &blob, const QVector<T> &recs) {
+    while (blob.size() % 8) blob.append('\0');
+    Section s{ quint32(blob.size()), quint32(recs.size()) };
+    blob.append(reinterpret_cast<const char *>(recs.constData()), qsizetype(recs.size()) * sizeof(T));
+    return s;
+}
+
+static bool compile(const QString &in, const QString &outPath, double cellSize) {
+    QFile f(in);
+    if (!f.open(QIODevice::ReadOnly)) { out << "can't read " << in << "\n"; return false; }
+    QJsonParseError pe;
+    const QJsonObject root = QJsonDocument::fromJson(f.readAll(), &pe).object();
+    if (pe.error != QJsonParseError::NoError) { out << in << ": " << pe.errorString() << "\n"; return false; }
+    if (root.value("interaction").toArray().isEmpty()) { out << in << ": legacy level, skipped\n"; return false; }
+
+    Strings strings;
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    h.magic = kMagic;
+    h.version = kVersion;
+    h.world = fromRect(jsonToRect(root.value("world")));
+    h.window = fromRect(jsonToRect(root.value("window")));
+    h.basePath = strings.intern(root.value("basePath").toString(":assets/"));
+
+    QVector<ShapeRec> shapes;
+    for (auto v : root.value("interaction").toArray()) {
+        const QJsonObject o = v.toObject();
+        ShapeRec s;
+        std::memset(&s, 0, sizeof(s));
+        s.rect = fromRect(jsonToRect(o.value("rect")));
+        s.id = strings.intern(o.value("id").toString("dummy"));
+        const QString kind = o.value("shape").toString("rect");
+        s.kind = kind == "rect" ? Rect : (kind == "tri_left" ? TriLeft : TriRight);
+        s.isWall = o.value("is_wall").toBool(false);
+        shapes << s;
+    }
+
+    QVector<AreaRec> areas;
+    for (auto v : root.value("areas").toArray()) {
+        const QJsonObject o = v.toObject();
+        const QString script = o.value("script").toString();
+        areas << AreaRec{ fromRect(jsonToRect(o.value("rect"))),
+                          strings.intern(o.value("id").toString("dummy")),
+                          strings.intern(o.value("title").toString(QString::fromUtf8("øf"))),
+                          script.isEmpty() ? kNoString : strings.intern(script), 0 };
+    }
+
+    QVector<EnemyRec> enemies;
+    for (auto v : root.value("enemies").toArray()) {
+        const QJsonObject o = v.toObject();
+        const QJsonObject pos = o.value("pos").toObject();
+        EnemyRec e;
+        std::memset(&e, 0, sizeof(e));
+        e.x = pos.value("x").toDouble();
+        e.y = pos.value("y").toDouble();
+        e.type = strings.intern(o.value("type").toString());
+        e.facingLeft = o.value("facing").toString("left") != "right";
+        enemies << e;
+    }
+
+    QVector<ImageRec> images;
+    for (auto v : root.value("graphics").toArray()) {
+        const QJsonObject o = v.toObject();
+        const QJsonObject pos = o.value("pos").toObject();
+        images << ImageRec{ pos.value("x").toDouble(), pos.value("y").toDouble(),
+                            o.value("rotation").toDouble(0), o.value("scaleX").toDouble(1.0),
+                            o.value("scaleY").toDouble(1.0), o.value("z").toDouble(0),
+                            strings.intern(o.value("id").toString()), strings.intern(o.value("path").toString()) };
+    }
+
+    QVector<ParallaxRec> parallax;
+    for (auto v : root.value("parallax").toArray()) {
+        const QJsonObject o = v.toObject();
+        const QJsonArray off = o.value("off").toArray(), rate = o.value("rate").toArray();
+        ParallaxRec p;
+        std::memset(&p, 0, sizeof(p));
+        p.offX = off.at(0).toDouble(0.0); p.offY = off.at(1).toDouble(0.0);
+        p.rateX = rate.at(0).toDouble(0.0); p.rateY = rate.at(1).toDouble(0.0);
+        p.scale = o.value("scale").toDouble();
+        p.z = o.value("z").toInt();
+        p.image = strings.intern(o.value("image").toString());
+        p.wrap = o.value("wrap").toBool();
+        parallax << p;
+    }
+
+    // Uniform grid over the world plus anything sticking out of it
+    QRectF span = toRect(h.world);
+    for (const ShapeRec &s : shapes) span |= toRect(s.rect);
+    h.cellSize = cellSize;
+    h.gridX = std::floor(span.left() / cellSize) * cellSize;
+    h.gridY = std::floor(span.top() / cellSize) * cellSize;
+    h.cols = quint32(qMax(1.0, std::ceil((span.right() - h.gridX) / cellSize)));
+    h.rows = quint32(qMax(1.0, std::ceil((span.bottom() - h.gridY) / cellSize)));
+
+    QVector<QVector<quint32>> buckets(int(h.cols * h.rows));
+    for (int i = 0; i < shapes.size(); ++i) {
+        const QRectF r = toRect(shapes[i].rect);
+        const int c0 = qBound(0, int(std::floor((r.left() - h.gridX) / cellSize)), int(h.cols) - 1);
+        const int c1 = qBound(0, int(std::floor((r.right() - h.gridX) / cellSize)), int(h.cols) - 1);
+        const int r0 = qBound(0, int(std::floor((r.top() - h.gridY) / cellSize)), int(h.rows) - 1);
+        const int r1 = qBound(0, int(std::floor((r.bottom() - h.gridY) / cellSize)), int(h.rows) - 1);
+        for (int y = r0; y <= r1; ++y)
+            for (int x = c0; x <= c1; ++x) buckets[y * int(h.cols) + x] << quint32(i);
+    }
+    QVector<CellRec> cells;
+    QVector<quint32> cellShapes;
+    for (const auto &b : buckets) {
+        cells << CellRec{ quint32(cellShapes.size()), quint32(b.size()) };
+        cellShapes << b;
+    }
+
+    QByteArray blob(sizeof(Header), '\0');
+    h.shapes = append(blob, shapes);
+    h.areas = append(blob, areas);
+    h.enemies = append(blob, enemies);
+    h.images = append(blob, images);
+    h.parallax = append(blob, parallax);
+
+    QVector<StringRec> stringRecs;
+    QByteArray text;
+    for (const QByteArray &s : strings.all()) { stringRecs << StringRec{ quint32(text.size()), quint32(s.size()) }; text += s; }
+    h.strings = append(blob, stringRecs);
+    const quint32 textOffset = quint32(blob.size());
+    blob += text;
+    for (StringRec &s : stringRecs) s.offset += textOffset;
+    std::memcpy(blob.data() + h.strings.offset, stringRecs.constData(), size_t(stringRecs.size()) * sizeof(StringRec));
+
+    h.cells = append(blob, cells);
+    h.cellShapes = append(blob, cellShapes);
+    h.fileSize = quint32(blob.size());
+    std::memcpy(blob.data(), &h, sizeof(h));
+
+    QFile o(outPath);
+    if (!o.open(QIODevice::WriteOnly) || o.write(blob) != blob.size()) { out << "can't write " << outPath << "\n"; return false; }
+    out << in << " -> " << outPath << ": " << shapes.size() << " shapes, " << areas.size() << " areas, "
+        << enemies.size() << " enemies, "
+        << images.size() << " images, " << parallax.size() << " layers, " << strings.all().size() << " strings, "
+        << h.cols << "x" << h.rows << " cells, " << blob.size() << " bytes\n";
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments().mid(1);
+    double cellSize = 256.0;
+    QString outPath;
+    QStringList inputs;
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--cell" && i + 1 < args.size()) cellSize = qMax(1.0, args[++i].toDouble());
+        else if (args[i] == "-o" && i + 1 < args.size()) outPath = args[++i];
+        else inputs << args[i];
+    }
+    if (inputs.isEmpty() || (!outPath.isEmpty() && inputs.size() > 1)) {
+        out << "usage: levelc [--cell <size>] [-o <out.pbl>] <level.json>...\n";
+        return 1;
+    }
+
+    bool ok = true;
+    for (const QString &in : inputs) {
+        const QFileInfo fi(in);
+        ok &= compile(in, outPath.isEmpty() ? fi.path() + '/' + fi.completeBaseName() + ".pbl" : outPath, cellSize);
+    }
+    return ok ? 0 : 1;
+}
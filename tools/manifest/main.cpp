@@ -0,0 +1,147 @@
+// manifest — resolves every image the levels refer to, once, at bake time.
+//
+//   manifest <source dir> [output, default manifest.json]
+//
+// platformer.pro builds it and rebakes the game's manifest on every build
+// that touches a .qrc, a level or the art.
+//
+// Reads every .qrc in the source dir, then every level JSON listed in them,
+// and resolves each graphic and parallax image with the same fallback rules
+// the game used to probe at runtime. The result maps
+//   "<level path>|<image path as written>" -> resource path
+// and records size and SHA-1 of every image. Missing images are errors,
+// images matching more than one candidate are reported as ambiguous.
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QSet>
+#include <QTextStream>
+#include <QXmlStreamReader>
+
+static QTextStream out(stdout);
+
+struct Resources {
+    QMap<QString, QString> files; // ":/prefix/name" -> file on disk
+};
+
+static void readQrc(const QString &qrc, Resources &res) {
+    QFile f(qrc);
+    if (!f.open(QIODevice::ReadOnly)) { out << "can't read " << qrc << "\n"; return; }
+    const QString dir = QFileInfo(qrc).path() + '/';
+    QXmlStreamReader xml(&f);
+    QString prefix = "/";
+    while (!xml.atEnd()) {
+        if (!xml.readNextStartElement()) continue;
+        if (xml.name() == u"qresource") {
+            prefix = xml.attributes().value("prefix").toString();
+            if (!prefix.endsWith('/')) prefix += '/';
+        } else if (xml.name() == u"file") {
+            const QString alias = xml.attributes().value("alias").toString();
+            const QString file = xml.readElementText().trimmed();
+            res.files.insert(':' + prefix + (alias.isEmpty() ? file : alias), dir + file);
+        }
+    }
+}
+
+// QFile treats ":assets/x" like ":/assets/x"
+static QString normalized(const QString &path) {
+    if (path.startsWith(':') && !path.startsWith(":/")) return ":/" + path.mid(1);
+    return path;
+}
+
+// Same as Assets::exists: a converted .qoi counts
+static bool exists(const Resources &res, const QString &path) {
+    const QString p = normalized(path);
+    if (res.files.contains(p)) return true;
+    const QFileInfo fi(p);
+    return res.files.contains(fi.path() + '/' + fi.completeBaseName() + ".qoi");
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    if (args.size() < 2) { out << "usage: manifest <source dir> [output]\n"; return 1; }
+    const QDir src(args.at(1));
+    const QString output = args.size() > 2 ? args.at(2) : QString("manifest.json");
+
+    Resources res;
+    for (const QString &qrc : src.entryList({"*.qrc"}, QDir::Files, QDir::Name))
+        if (!qrc.endsWith(".qoi.qrc")) readQrc(src.filePath(qrc), res);
+
+    QJsonObject ids, assets;
+    QSet<QString> used;
+    int missing = 0, ambiguous = 0;
+
+    for (auto it = res.files.constBegin(); it != res.files.constEnd(); ++it) {
+        if (!it.key().endsWith(".json")) continue;
+        QFile f(it.value());
+        if (!f.open(QIODevice::ReadOnly)) continue;
+        const QJsonObject root = QJsonDocument::fromJson(f.readAll()).object();
+        if (!root.contains("graphics") && !root.contains("parallax")) continue; // not a level
+
+        const QString levelPath = it.key().left(it.key().lastIndexOf('/') + 1);
+        const QString basePath = root.value("basePath").toString(":assets/");
+
+        for (auto v : root.value("graphics").toArray()) {
+            const QString imagePath = v.toObject().value("path").toString();
+            const QString id = levelPath + '|' + imagePath;
+            if (ids.contains(id)) continue;
+
+            // Fallback order of the old runtime probe; the first hit wins
+            const QString name = imagePath.split('/').last();
+            QStringList hits;
+            for (const QString &c : { basePath + imagePath, basePath + name, levelPath + imagePath, levelPath + name, imagePath })
+                if (exists(res, c) && !hits.contains(normalized(c))) hits << normalized(c);
+
+            if (hits.isEmpty()) { out << "missing: " << it.key() << ": " << imagePath << "\n"; ++missing; continue; }
+            if (hits.size() > 1) { out << "ambiguous: " << it.key() << ": " << imagePath << " -> " << hits.join(", ") << "\n"; ++ambiguous; }
+            ids.insert(id, hits.first());
+            used << hits.first();
+        }
+        for (auto l : root.value("parallax").toArray()) {
+            const QString image = l.toObject().value("image").toString();
+            const QString resolved = normalized(levelPath + image);
+            if (!exists(res, resolved)) { out << "missing: " << it.key() << ": " << image << "\n"; ++missing; continue; }
+            ids.insert(levelPath + '|' + image, resolved);
+            used << resolved;
+        }
+    }
+
+    for (const QString &path : used) {
+        QString file = res.files.value(path);
+        if (file.isEmpty()) { // only the .qoi is shipped
+            const QFileInfo fi(path);
+            file = res.files.value(fi.path() + '/' + fi.completeBaseName() + ".qoi");
+        }
+        QFile f(file);
+        if (!f.open(QIODevice::ReadOnly)) { out << "can't read " << file << "\n"; ++missing; continue; }
+        QCryptographicHash h(QCryptographicHash::Sha1);
+        h.addData(&f);
+        QSize size = QImageReader(file).size();
+        if (!size.isValid() && file.endsWith(".qoi")) { // header: "qoif", width, height (big endian)
+            f.seek(4);
+            const QByteArray hd = f.read(8);
+            const uchar *p = reinterpret_cast<const uchar *>(hd.constData());
+            if (hd.size() == 8) size = QSize(p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3], p[4] << 24 | p[5] << 16 | p[6] << 8 | p[7]);
+        }
+        assets.insert(path, QJsonObject{ {"w", size.width()}, {"h", size.height()},
+                                         {"sha1", QString::fromLatin1(h.result().toHex())} });
+    }
+
+    QJsonObject root{ {"version", 1}, {"ids", ids}, {"assets", assets} };
+    QFile o(output);
+    if (!o.open(QIODevice::WriteOnly)) { out << "can't write " << output << "\n"; return 1; }
+    o.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+
+    out << ids.size() << " ids, " << assets.size() << " assets, " << missing << " missing, "
+        << ambiguous << " ambiguous -> " << output << "\n";
+    return missing ? 1 : 0;
+}
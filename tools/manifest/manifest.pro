@@ -0,0 +1,10 @@
+# Bakes manifest.json from the .qrc files (see Assets::resolve).
+# platformer.pro builds and runs it; by hand:
+#   qmake tools/manifest && make && ./manifest <source dir> manifest.json
+TEMPLATE = app
+TARGET = manifest
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+SOURCES = main.cpp
@@ -0,0 +1,118 @@
+// spriteconv — writes a .qoi next to every PNG/JPEG it is given and checks
+// that it decodes back to the same pixels.
+//
+//   spriteconv [--qrc] <file|dir|file.qrc>...
+//
+// Directories are walked recursively. A .qrc argument converts every image
+// it lists; with --qrc it also writes <name>.qoi.qrc listing the .qoi files
+// in place of the originals, for builds that ship QOI only.
+
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include "qoi.h"
+
+static QTextStream out(stdout);
+
+struct Totals { int files = 0; qint64 srcBytes = 0, qoiBytes = 0, srcNs = 0, qoiNs = 0; };
+
+static bool isImage(const QString &path) {
+    const QString s = QFileInfo(path).suffix().toLower();
+    return s == "png" || s == "jpg" || s == "jpeg";
+}
+
+static QString qoiPath(const QString &path) {
+    const QFileInfo fi(path);
+    return fi.path() + '/' + fi.completeBaseName() + ".qoi";
+}
+
+static bool convert(const QString &path, Totals &t) {
+    QFile src(path);
+    if (!src.open(QIODevice::ReadOnly)) { out << "can't read " << path << "\n"; return false; }
+    const QByteArray srcData = src.readAll();
+
+    QElapsedTimer timer; timer.start();
+    QImage img = QImage::fromData(srcData);
+    const qint64 srcNs = timer.nsecsElapsed();
+    if (img.isNull()) { out << "can't decode " << path << "\n"; return false; }
+
+    const QByteArray qoi = Qoi::encode(img);
+    timer.restart();
+    const QImage back = Qoi::decode(qoi);
+    const qint64 qoiNs = timer.nsecsElapsed();
+
+    // Compare in the format Assets ends up with
+    const QImage::Format fmt = img.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32;
+    if (back != img.convertToFormat(fmt)) { out << "round trip mismatch " << path << "\n"; return false; }
+
+    QFile dst(qoiPath(path));
+    if (!dst.open(QIODevice::WriteOnly) || dst.write(qoi) != qoi.size()) {
+        out << "can't write " << dst.fileName() << "\n";
+        return false;
+    }
+
+    ++t.files; t.srcBytes += srcData.size(); t.qoiBytes += qoi.size(); t.srcNs += srcNs; t.qoiNs += qoiNs;
+    out << path << ": " << srcData.size() << " -> " << qoi.size() << " bytes, decode "
+        << srcNs / 1000 << " -> " << qoiNs / 1000 << " us\n";
+    return true;
+}
+
+// Images listed in a .qrc, as paths relative to the working directory
+static QStringList qrcImages(const QString &qrc, QString *text) {
+    QFile f(qrc);
+    if (!f.open(QIODevice::ReadOnly)) return {};
+    *text = QString::fromUtf8(f.readAll());
+    const QString dir = QFileInfo(qrc).path() + '/';
+    QStringList files;
+    static const QRegularExpression re("<file[^>]*>([^<]+)</file>");
+    for (auto it = re.globalMatch(*text); it.hasNext();) {
+        const QString file = it.next().captured(1).trimmed();
+        if (isImage(file)) files << dir + file;
+    }
+    return files;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments().mid(1);
+    const bool writeQrc = args.removeAll("--qrc") > 0;
+    if (args.isEmpty()) {
+        out << "usage: spriteconv [--qrc] <file|dir|file.qrc>...\n";
+        return 1;
+    }
+
+    Totals t;
+    bool ok = true;
+    for (const QString &arg : args) {
+        const QFileInfo fi(arg);
+        if (fi.isDir()) {
+            QDirIterator it(arg, {"*.png", "*.jpg", "*.jpeg"}, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) ok &= convert(it.next(), t);
+        } else if (fi.suffix() == "qrc") {
+            QString text;
+            for (const QString &file : qrcImages(arg, &text)) ok &= convert(file, t);
+            if (writeQrc) {
+                static const QRegularExpression ext("(<file[^>]*>[^<]+)\\.(png|jpg|jpeg)</file>", QRegularExpression::CaseInsensitiveOption);
+                text.replace(ext, "\\1.qoi</file>");
+                QFile f(fi.path() + '/' + fi.completeBaseName() + ".qoi.qrc");
+                if (f.open(QIODevice::WriteOnly)) f.write(text.toUtf8());
+                else { out << "can't write " << f.fileName() << "\n"; ok = false; }
+            }
+        } else {
+            ok &= convert(arg, t);
+        }
+    }
+
+    if (t.files) {
+        out << t.files << " files: " << t.srcBytes << " -> " << t.qoiBytes << " bytes, decode "
+            << t.srcNs / 1000000 << " -> " << t.qoiNs / 1000000 << " ms\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+# Converts shipped PNG/JPEG sprites to QOI (see qoi.h). Build on its own:
+#   qmake tools/spriteconv && make
+TEMPLATE = app
+TARGET = spriteconv
+QT = core gui
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES = main.cpp \
+    ../../qoi.cpp
+HEADERS = \
+    ../../qoi.h
@@ -0,0 +1,90 @@
+#include <QDebug>
+
+#include "triggers.h"
+
+namespace {
+
+// The title's command and policy as script source
+QString titleSource(const QString &title, bool *repeat) {
+    const QStringList words = title.split(' ', Qt::SkipEmptyParts);
+    if (words.isEmpty()) return QString();
+    QString source;
+    if (words.first().startsWith("Knap")) source = "walls off";
+    else if (words.first().startsWith("NextLevel")) source = "nextlevel";
+    for (int i = 1; i < words.size(); ++i) {
+        if (words[i] == "repeat") *repeat = true;
+        else if (words[i] == "exit") source.prepend("exit:;");
+        else qWarning() << "area" << title << "- unknown" << words[i];
+    }
+    return source;
+}
+
+}
+
+void Triggers::load(const QList<Area> &areas) {
+    clear();
+    m_triggers.reserve(areas.size());
+    m_shapes.reserve(areas.size());
+    for (const Area &area : areas) {
+        Trigger t;
+        // The title's "exit" policy switches sections; the script starts in
+        // enter: again, as script.h documents
+        const QString source = titleSource(area.title, &t.repeat) + "\nenter:\n" + area.script;
+        QString err;
+        if (!Script::compile(source, m_program, t.entries, &err)) {
+            qWarning() << "area" << area.title << "script:" << err;
+            continue;
+        }
+        if (t.entries.enter < 0 && t.entries.exit < 0 && t.entries.inside < 0) continue;
+        t.id = area.id;
+        t.rect = area.rect;
+        m_triggers.push_back(t);
+        Shape s; s.id = t.id; s.shape = Shape::Rect; s.rect = t.rect;
+        m_shapes.push_back(s);
+    }
+    m_index.build(m_shapes);
+}
+
+void Triggers::clear() {
+    m_triggers.clear();
+    m_program.clear();
+    m_shapes.clear();
+    m_index.clear();
+    m_inside.clear();
+    m_last = QRectF();
+}
+
+void Triggers::update(const QRectF &box, QVector<TriggerEvent> &fired) {
+    fired.clear();
+    if (m_triggers.isEmpty()) return;
+
+    if (box != m_last) {
+        m_last = box;
+        for (int k = m_inside.size() - 1; k >= 0; --k) {
+            const int i = m_inside[k];
+            Trigger &t = m_triggers[i];
+            if (t.rect.intersects(box)) continue;
+            t.inside = false;
+            m_inside.remove(k);
+            fire(i, t.entries.exit, fired);
+            t.spent = !t.repeat;
+        }
+
+        ShapeIndex::Hits hits;
+        m_index.query(box, hits);
+        for (int i : hits) {
+            Trigger &t = m_triggers[i];
+            if (t.inside || !t.rect.intersects(box)) continue;
+            t.inside = true;
+            m_inside.append(i);
+            fire(i, t.entries.enter, fired);
+        }
+    }
+
+    for (int i : m_inside) fire(i, m_triggers[i].entries.inside, fired);
+}
+
+void Triggers::fire(int i, int entry, QVector<TriggerEvent> &fired) {
+    if (entry < 0 || m_triggers[i].spent) return;
+    fired.push_back(TriggerEvent{ i, entry });
+}
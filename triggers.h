@@ -0,0 +1,65 @@
+#ifndef TRIGGERS_H
+#define TRIGGERS_H
+
+#include <QList>
+#include <QRectF>
+#include <QVarLengthArray>
+#include <QVector>
+
+#include "platform.h"
+#include "script.h"
+#include "shapeindex.h"
+
+// ------------------------------
+// Level areas as trigger volumes, each running a script (see script.h)
+// compiled at load from the area's "script" and its title:
+//   "Knap01"              walls off
+//   "NextLevel01"         nextlevel
+//   "<title> repeat"      run on every visit, not just the first
+//   "<title> exit"        the title's command runs on leaving
+// The number only tells areas apart. Areas with neither a known title nor
+// a script are dropped, as are those whose script doesn't compile.
+//
+// update() looks the box up in a ShapeIndex over the areas and reports
+// transitions only: enter and exit scripts run once per crossing, nothing
+// is looked up while the box doesn't move. Inside scripts run every tick
+// while the box is in the area.
+// ------------------------------
+struct Trigger {
+    Id id;
+    QRectF rect;
+    Script::Entries entries;
+    bool repeat = false;
+    bool inside = false;
+    bool spent = false;          // first visit over, and not repeating
+};
+
+struct TriggerEvent {
+    int trigger;                 // into Triggers::triggers()
+    int entry;                   // into Triggers::program()
+};
+
+class Triggers {
+public:
+    void load(const QList<Area> &areas);
+    void clear();
+
+    // Scripts to run for box this tick, in fired (replaced): exits, then
+    // enters, then insides
+    void update(const QRectF &box, QVector<TriggerEvent> &fired);
+
+    const QVector<Trigger> &triggers() const { return m_triggers; }
+    const Script::Program &program() const { return m_program; }
+
+private:
+    void fire(int i, int entry, QVector<TriggerEvent> &fired);
+
+    QVector<Trigger> m_triggers;
+    Script::Program m_program;   // every trigger's code, back to back
+    QList<Shape> m_shapes;       // their rects, what m_index is built from
+    ShapeIndex m_index;
+    QVarLengthArray<int, 8> m_inside;
+    QRectF m_last;               // box of the last update
+};
+
+#endif // TRIGGERS_H